@@ -13,13 +13,13 @@
 #include <execinfo.h>
 #include <pthread.h>
 #include <signal.h>
-#include <sys/prctl.h>
 
 #include "3rdparty/backward/backward.hpp"
 #include "3rdparty/tinyformat/tinyformat.h"
 #include "common/system/sysmanager.h"
 #include "common/exception/misterexception.h"
 #include "common/events/messagecenter.h"
+#include "common/thread/threadpolicy.h"
 #include "common/file/directorymanager.h"
 #include "common/file/filemanager.h"
 #include "fpga/fpgadevice.h"
@@ -28,9 +28,15 @@
 #include "io/input/inputmanager.h"
 #include "io/input/baseinputdevice.h"
 #include "common/file/scandir/scandir.h"
+#include "common/file/scandir/directoryindex.h"
+#include "common/helpers/collationsort.h"
 #include "gui/osd/osd.h"
+#include "gui/osd/osdpresenter.h"
+#include "gui/osd/imagerendertarget.h"
+#include "common/diagnostics/latencytracer.h"
 #include "io/input/keyboard.h"
 #include "io/input/devicedetector/devicedetector.h"
+#include "io/input/loadgen/inputloadgenerator.h"
 
 using namespace std;
 using namespace backward;
@@ -80,6 +86,39 @@ void testScanDir()
 			);
 }
 
+// Cores folder is listed twice: first call scans and builds the index, second one is served from the index
+void testDirectoryIndex()
+{
+	for (int pass = 0; pass < 2; pass++)
+	{
+		uint64_t started = LatencyTracer::now();
+
+		ScanDir instance;
+		instance.scanFolder(string(DATA_ROOT), "fpga_cores", ScanDir::getFPGACoreFilter(), ScanDir::getAlphaSortCaseInsensitive());
+		auto results = instance.getScanResults();
+
+		LOGINFO("Pass %d: %d entries listed in %llu us (index file: '%s')", pass, results.size(), LatencyTracer::now() - started,
+			DirectoryIndex::getIndexFilePath(DATA_ROOT, "fpga_cores").c_str());
+	}
+}
+
+void testCollationSort()
+{
+	vector<string> names = { "Game 10", "game 2", "Game 1", "Game 01", "ZX Spectrum", "zx81", "1942", "Arcade" };
+
+	CollationSort collation;
+	for (const string& name : names)
+	{
+		collation.add(name);
+	}
+	collation.sort();
+
+	for (size_t i = 0; i < collation.size(); i++)
+	{
+		LOGINFO("%d: %s", i, names[collation.getItemIndex(i)].c_str());
+	}
+}
+
 void testDirectories()
 {
 	DirectoryManager& dirManager = DirectoryManager::instance();
@@ -163,6 +202,167 @@ void testOSD()
 	osd.hide();
 }
 
+// Render OSD into image files instead of FPGA. Draw and present costs are reported separately
+void testOSDHeadless()
+{
+	OSDPresenter& presenter = OSDPresenter::instance();
+	ImageRenderTarget target("/tmp", OSDImageFormatEnum::PGM);
+
+	presenter.removeTarget(presenter.getFPGATarget());
+	presenter.addTarget(&target);
+
+	OSD& osd = OSD::instance();
+	uint64_t drawTime = 0;
+	const int frames = 100;
+
+	for (int frame = 0; frame < frames; frame++)
+	{
+		uint64_t started = LatencyTracer::now();
+
+		osd.setTitle("Headless 1234567");
+		for (int line = 0; line < 16; line++)
+		{
+			osd.printLine(line, " Frame 0123456789_abcdefghij_0123456789", (line + frame) % 2 == 1);
+		}
+		osd.compose();
+
+		drawTime += LatencyTracer::now() - started;
+	}
+
+	// Let presenter thread finish pending frame
+	sleep(1);
+
+	presenter.removeTarget(&target);
+	presenter.addTarget(presenter.getFPGATarget());
+
+	OSDPresenterStatistics stats = presenter.getStatistics();
+	LOGINFO("OSD headless: %d frames drawn in %llu us, %u presented in %llu us, %u dropped, %u image(s) written. Last: '%s'",
+		frames, drawTime, stats.presented, stats.presentTime, stats.dropped, target.getFramesWritten(), target.getLastFile().c_str());
+}
+
+// Compare word-wide OSD region operations with per-pixel reference on random content / rects, then benchmark both
+bool testOSDRaster()
+{
+	bool result = true;
+
+	OSD& osd = OSD::instance();
+	const size_t frameSize = OSD::OSD_HIGHRES_HEIGHT_LINES * OSD::OSD_LINE_LENGTH_BYTES;
+	const char* names[] = { "fill", "clear", "invert", "blit", "scroll" };
+
+	// Random regions exceed the screen by up to 16px in each direction (to test clipping), bitmap has to cover them
+	const uint16_t maxWidth = OSD::OSD_LINE_LENGTH_BYTES + 16;
+	const uint8_t maxHeight = OSD::OSD_HIGHRES_HEIGHT_PX + 16;
+	const size_t bitmapSize = ((maxHeight + 7) / 8) * maxWidth;
+
+	uint8_t initial[frameSize];
+	uint8_t expected[frameSize];
+	uint8_t bitmap[bitmapSize];
+
+	srand(1);
+
+	for (int iteration = 0; iteration < 20000 && result; iteration++)
+	{
+		for (size_t idx = 0; idx < frameSize; idx++)
+		{
+			initial[idx] = rand() & 0xFF;
+		}
+
+		for (size_t idx = 0; idx < bitmapSize; idx++)
+		{
+			bitmap[idx] = rand() & 0xFF;
+		}
+
+		int op = iteration % 5;
+		uint8_t left = rand() % OSD::OSD_LINE_LENGTH_BYTES;
+		uint8_t top = rand() % OSD::OSD_HIGHRES_HEIGHT_PX;
+		uint16_t width = rand() % maxWidth;
+		uint8_t height = rand() % maxHeight;
+		int dy = rand() % 64 - 32;
+
+		for (int pass = 0; pass < 2; pass++)
+		{
+			osd.blitReference(initial, OSD::OSD_LINE_LENGTH_BYTES, OSD::OSD_HIGHRES_HEIGHT_PX, 0, 0);
+
+			bool isReference = pass == 0;
+			switch (op)
+			{
+				case 0:
+					isReference ? osd.fillRectReference(left, top, width, height) : osd.fillRect(left, top, width, height);
+					break;
+				case 1:
+					isReference ? osd.fillRectReference(left, top, width, height, true) : osd.clearRect(left, top, width, height);
+					break;
+				case 2:
+					isReference ? osd.invertRectReference(left, top, width, height) : osd.invertRect(left, top, width, height);
+					break;
+				case 3:
+					isReference ? osd.blitReference(bitmap, width, height, left, top) : osd.blit(bitmap, width, height, left, top);
+					break;
+				case 4:
+					isReference ? osd.scrollReference(left, top, width, height, dy) : osd.scroll(left, top, width, height, dy);
+					break;
+			}
+
+			if (isReference)
+			{
+				memcpy(expected, osd.getFramebuffer(), frameSize);
+			}
+			else if (memcmp(expected, osd.getFramebuffer(), frameSize) != 0)
+			{
+				LOGERROR("%s: %s mismatch (left: %d, top: %d, width: %d, height: %d, dy: %d)", __PRETTY_FUNCTION__,
+					names[op], left, top, width, height, dy);
+				result = false;
+			}
+		}
+	}
+
+	// Benchmark: typical menu highlight bar and full screen operations
+	const int repeats = 1000;
+	for (int op = 0; op < 5 && result; op++)
+	{
+		uint64_t elapsed[2] = { 0, 0 };
+
+		for (int pass = 0; pass < 2; pass++)
+		{
+			bool isReference = pass == 0;
+			uint64_t started = LatencyTracer::now();
+
+			for (int idx = 0; idx < repeats; idx++)
+			{
+				switch (op)
+				{
+					case 0:
+						isReference ? osd.fillRectReference(16, 21, 240, 10) : osd.fillRect(16, 21, 240, 10);
+						break;
+					case 1:
+						isReference ? osd.fillRectReference(0, 0, 256, 128, true) : osd.clearRect(0, 0, 256, 128);
+						break;
+					case 2:
+						isReference ? osd.invertRectReference(16, 21, 240, 10) : osd.invertRect(16, 21, 240, 10);
+						break;
+					case 3:
+						isReference ? osd.blitReference(bitmap, 240, 11, 16, 21) : osd.blit(bitmap, 240, 11, 16, 21);
+						break;
+					case 4:
+						isReference ? osd.scrollReference(16, 8, 240, 120, -3) : osd.scroll(16, 8, 240, 120, -3);
+						break;
+				}
+			}
+
+			elapsed[pass] = LatencyTracer::now() - started;
+		}
+
+		LOGINFO("OSD %s: reference %llu ns, word-wide %llu ns per call", names[op],
+			elapsed[0] * 1000 / repeats, elapsed[1] * 1000 / repeats);
+	}
+
+	osd.clear();
+
+	LOGINFO("OSD raster operations test %s", result ? "passed" : "failed");
+
+	return result;
+}
+
 void testDeviceDetector()
 {
 	DeviceDetector& detector = DeviceDetector::instance();
@@ -254,6 +454,64 @@ void testEventMessaging()
 
 }
 
+// Topic with functor observer only (no onMessageEvent subscription) has to be delivered as well
+void testFunctorObserver()
+{
+	class TestObserver : public EventObserver
+	{
+	public:
+		atomic<int> delivered { 0 };
+
+	protected:
+		void onMessageEvent(const EventMessageBase&) {};
+	};
+
+	TestObserver observer;
+	MessageCenter& center = MessageCenter::defaultCenter();
+	center.addObserver("test_functor_only", &observer,
+		[](const EventObserver* obj, const EventMessageBase&)
+		{
+			((TestObserver*)obj)->delivered++;
+		}
+	);
+
+	center.post("test_functor_only", nullptr, nullptr);
+
+	for (int i = 0; i < 100 && observer.delivered == 0; i++)
+	{
+		usleep(1000);
+	}
+
+	center.removeObserver(&observer);
+
+	if (observer.delivered == 1)
+	{
+		LOGINFO("%s: functor-only topic delivered", __PRETTY_FUNCTION__);
+	}
+	else
+	{
+		LOGERROR("%s: functor-only topic delivered %d time(s) instead of 1", __PRETTY_FUNCTION__, (int)observer.delivered);
+	}
+}
+
+// Stress test for the whole input stack. Requires uinput kernel module and running DeviceDetector / InputPoller
+void testInputLoad()
+{
+	InputLoadProfile profile;
+	profile.keyboards = 2;
+	profile.mice = 2;
+	profile.joysticks = 4;
+	profile.duration = 30000;
+
+	InputLoadGenerator generator(profile);
+
+	InputLoadResult result;
+	if (generator.run(result))
+	{
+		LOGINFO("%s", InputLoadGenerator::dump(result).c_str());
+	}
+}
+
 // ==========================================================================================
 
 void handler(int sig)
@@ -329,6 +587,12 @@ int main(int argc, char *argv[])
 		// TODO: Remove debug code
 		CoreType coreType = command.getCoreType();
 
+#ifdef _ENABLE_LATENCY_TRACING
+		// Collect input latency histograms (reported to the log each LATENCY_REPORT_INTERVAL). Off in regular builds:
+		// tracing adds timestamping and histogram update to each input event
+		LatencyTracer::instance().setEnabled(true);
+#endif
+
 		LOGINFO("Core name: %s", command.getCoreName());
 		LOGINFO("Core config: %s", command.getCoreConfig());
 
@@ -342,15 +606,21 @@ int main(int argc, char *argv[])
 		//for (int i = 0; i < 1000; i++)
 		{
 			testEventMessaging();
+			//testFunctorObserver();
 			//testDeviceDetector();
 			//testInputDevices();
+			//testInputLoad();
 
 			sleep(100);
 
 			testScanDir();
 			//testFilesystem();
 			//testDirectories();
+			//testDirectoryIndex();
+			//testCollationSort();
 			//testOSD();
+			//testOSDHeadless();
+			//testOSDRaster();
 		}
 		// End of debug code
 
@@ -393,10 +663,9 @@ int main(int argc, char *argv[])
 
 void init()
 {
-	// Set main thread name
+	// Set main thread name and policy (all threads created later inherit its CPU affinity)
 	const string threadName("main");
-	pthread_getname_np(pthread_self(), (char*)threadName.c_str(), threadName.size());
-	prctl(PR_SET_NAME, threadName.c_str(), 0, 0, 0);
+	ThreadPolicy::getDefault(threadName).apply(threadName);
 
 	// Ensure that /config folder exists on data disk
 	sysmanager::ensureConfigFolderExists();
@@ -409,6 +678,9 @@ void init()
 
 	// Notify application
 	application.onStart();
+
+	// All long-living threads are started - keep their pages (and the rest of already mapped memory) in RAM
+	ThreadPolicy::lockMemory();
 }
 
 void dispose()
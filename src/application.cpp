@@ -9,7 +9,11 @@
 #include "fpga/fpgacommand.h"
 #include "io/input/devicedetector/devicedetector.h"
 #include "io/input/inputmanager.h"
+#include "io/input/devicecache.h"
 #include "io/input/commandcenter.h"
+#include "io/input/mouseemulator.h"
+#include "common/timer/timerservice.h"
+#include "gui/osd/osdpresenter.h"
 
 using namespace std;
 
@@ -30,11 +34,24 @@ void Application::onStart()
 	// Initialize FPGA communications
 	FPGADevice& fpga = FPGADevice::instance();
 
+	// Start timer service (key repeat, autofire)
+	TimerService& timers = TimerService::instance();
+	if (timers.init())
+	{
+		timers.start();
+	}
+
+	// Start OSD presenter (menu rendering never waits for FPGA transfers)
+	OSDPresenter::instance().start();
+
 	// Start input device detector
 	DeviceDetector& detector = DeviceDetector::instance();
 	detector.init();
 	detector.start();
 
+	// Load known input devices capabilities (speeds up devices detection)
+	InputDeviceCache::instance().load();
+
 	// Start input manager
 	InputManager& inputmgr = InputManager::instance();
 	inputmgr.detectDevices();
@@ -43,6 +60,13 @@ void Application::onStart()
 	// Start command center
 	CommandCenter& cmdcenter = CommandCenter::instance();
 
+	// Start keypad / joystick mouse emulation engine
+	MouseEmulator& emulator = MouseEmulator::instance();
+	if (emulator.init())
+	{
+		emulator.start();
+	}
+
 	// More initialization
 	startupDiagnostics();
 }
@@ -59,6 +83,18 @@ void Application::onTerminate()
 	// Stop polling for devices
 	InputManager& inputmgr = InputManager::instance();
 	inputmgr.stopPolling();
+
+	// Stop cached device capabilities re-validation
+	InputDeviceCache::instance().dispose();
+
+	// Stop mouse emulation
+	MouseEmulator::instance().dispose();
+
+	// Stop OSD presenter
+	OSDPresenter::instance().dispose();
+
+	// Stop timers
+	TimerService::instance().dispose();
 }
 
 // Helper methods
@@ -31,14 +31,89 @@
 // Usually such buffer contains name of FPGA core to load after reboot.
 #define UBOOT_EXTRA_ENV_SIGNATURE 0x87654321
 
+// Dual-core Cortex-A9: one CPU is dedicated to latency-critical threads (input polling, FPGA I/O), the other one serves the rest
+#define CPU_CORE_BACKGROUND 0
+#define CPU_CORE_REALTIME 1
+
+// SCHED_FIFO priorities for real-time threads (1..99, higher value - higher priority)
+#define THREAD_PRIORITY_INPUT 50
+#define THREAD_PRIORITY_EVENTS 40
+
+// Thread stack sizes. Stacks of threads started before memory locking are locked completely, so they're kept small
+#define THREAD_STACK_SIZE_REALTIME (256 * 1024)		// Input polling, mouse emulation, timers
+#define THREAD_STACK_SIZE_EVENTS (1024 * 1024)		// Event queue (menu / command handling)
+#define THREAD_STACK_SIZE_BACKGROUND (1024 * 1024)
+
 // Limit max number of input devices supported
 // This limit includes total number of keyboards / mouses / joysticks that
 // can be connected to MiSTer board simultaneously
 #define MAX_INPUT_DEVICES 16
 
+// Input device descriptors are kept in array indexed by file descriptor number (default RLIMIT_NOFILE soft limit)
+#define MAX_POLLED_FD 1024
+
 // Limit max number of input events generated per device (so MAX_INPUT_DEVICES * MAX_INPUT_EVENTS buffer will be allocated)
 #define MAX_INPUT_EVENTS 10
 
+// Max number of joystick ports cores can handle (UIO_JOYSTICK0..UIO_JOYSTICK5)
+#define MAX_JOYSTICKS 6
+
+// Max number of analog axes tracked per joystick (hats are treated as digital and not counted)
+#define JOYSTICK_MAX_AXES 8
+
+// Joystick state is reported to the core not more often than once per frame (~60Hz)
+#define JOYSTICK_REPORT_INTERVAL 16 // 16ms
+
+// Paced OSD presentation: committed frames are pushed to FPGA not more often than once per frame (~60Hz)
+#define OSD_PRESENT_INTERVAL 16 // 16ms
+
+// Max time to wait for pending OSD changes before FPGA is reconfigured (presenter is suspended anyway)
+#define OSD_SUSPEND_TIMEOUT 1000 // 1s
+
+// Marquee scrolling of long names in OSD menu: one pixel column per tick (40 px/s)
+#define OSD_SCROLL_INTERVAL 25 // 25ms
+#define OSD_SCROLL_PAUSE 40 // Ticks to hold the beginning of the name before scrolling (1s)
+#define OSD_SCROLL_GAP 4 // Empty symbols between the end of the name and its repeated beginning
+
+// Type-ahead in menu lists: symbols typed with longer pause start a new prefix
+#define TYPEAHEAD_TIMEOUT 1000 // 1s
+
+// Asynchronous folder scanning: first batch is published as soon as one screen of entries is read,
+// then each SCAN_BATCH_SIZE entries (or SCAN_BATCH_INTERVAL, whichever comes first)
+#define SCAN_FIRST_BATCH_SIZE 32
+#define SCAN_BATCH_SIZE 1024
+#define SCAN_BATCH_INTERVAL 200 // 200ms
+
+// Folder listing indexes (one binary file per folder / filter, stored in CONFIG_DIR/DIRECTORY_INDEX_DIR)
+#define DIRECTORY_INDEX_DIR "dirindex"
+
+// Folder modified less than this time ago is not indexed: FAT keeps mtime with 2s granularity,
+// so change made within the same interval won't be noticed by mtime comparison
+#define DIRECTORY_INDEX_RACY_WINDOW 2 // 2s
+
+// Mouse emulation (keypad / joystick => mouse) runs with fixed tick (100Hz)
+#define MOUSE_EMU_TICK_INTERVAL 10 // 10ms
+
+// Joystick autofire: full press / release cycle (button state is toggled each half-period)
+#define AUTOFIRE_PERIOD_FAST 66 // 66ms (~15 shots per second)
+#define AUTOFIRE_PERIOD_MEDIUM 100 // 100ms (10 shots per second)
+#define AUTOFIRE_PERIOD_SLOW 200 // 200ms (5 shots per second)
+
+// Input latency histograms are dumped to the log not more often than each 10 seconds (and only if new samples were collected)
+#define LATENCY_REPORT_INTERVAL 10000 // 10s
+
+// Latency samples above this value are treated as invalid (device clock is not CLOCK_MONOTONIC or timestamp is missing)
+#define LATENCY_MAX_VALID 10000000 // 10s in microseconds
+
+// Max number of threads used for input devices probing at startup
+#define INPUT_PROBE_THREADS 4
+
+// Input device capabilities cache (stored in CONFIG_DIR)
+#define INPUT_DEVICE_CACHE_FILE "inputdevices.cache"
+
+// Cached device capabilities are re-validated by full probe in background after this delay
+#define DEVICE_CACHE_REVALIDATION_DELAY 2000 // 2s
+
 // ======== Events ============
 
 #define EVENT_DEVICE_INSERTED "device_inserted"
@@ -47,10 +122,14 @@
 #define EVENT_KEYBOARD "device_key"
 #define EVENT_MOUSE "device_mouse"
 #define EVENT_JOYSTICK "device_joystick"
+#define EVENT_KEY_REPEAT "key_repeat"
+#define EVENT_MENU_TICK "menu_tick"
 
 #define EVENT_SHOW_OSD "show_osd"
 #define EVENT_HIDE_OSD "hide_osd"
 
+#define EVENT_FOLDER_SCAN "folder_scan"
+
 #define EVENT_CORE_SELECTED "core_selected"
 #define EVENT_CORE_STARTED "core_started"
 
@@ -0,0 +1,266 @@
+#include "latencytracer.h"
+
+#include "../logger/logger.h"
+
+#include <string.h>
+#include <time.h>
+#include <sstream>
+#include "../../3rdparty/tinyformat/tinyformat.h"
+
+// LatencyHistogram class
+
+LatencyHistogram::LatencyHistogram()
+{
+	reset();
+}
+
+void LatencyHistogram::add(uint32_t value)
+{
+	m_buckets[getBucket(value)]++;
+	m_count++;
+
+	if (value > m_max)
+		m_max = value;
+}
+
+void LatencyHistogram::reset()
+{
+	memset(m_buckets, 0, sizeof(m_buckets));
+	m_count = 0;
+	m_max = 0;
+}
+
+uint32_t LatencyHistogram::getCount() const
+{
+	return m_count;
+}
+
+uint32_t LatencyHistogram::getMax() const
+{
+	return m_max;
+}
+
+// Returns upper bound of the bucket where requested percentile falls (but not more than max registered value)
+uint32_t LatencyHistogram::getPercentile(unsigned percent) const
+{
+	uint32_t result = 0;
+
+	if (m_count == 0)
+		return result;
+
+	// Rank of the sample (1-based) corresponding to requested percentile
+	uint64_t rank = ((uint64_t)m_count * percent + 99) / 100;
+	if (rank == 0)
+		rank = 1;
+
+	uint64_t accumulated = 0;
+	for (unsigned bucket = 0; bucket < BUCKETS; bucket++)
+	{
+		accumulated += m_buckets[bucket];
+		if (accumulated >= rank)
+		{
+			result = getBucketUpperBound(bucket);
+			break;
+		}
+	}
+
+	if (result > m_max)
+		result = m_max;
+
+	return result;
+}
+
+// Helper methods
+unsigned LatencyHistogram::getBucket(uint32_t value)
+{
+	unsigned result = value;
+
+	if (value >= LINEAR_BUCKETS)
+	{
+		unsigned exponent = 31 - __builtin_clz(value);
+		unsigned subBucket = (value >> (exponent - SUB_BUCKET_BITS)) & ((1 << SUB_BUCKET_BITS) - 1);
+
+		result = LINEAR_BUCKETS + ((exponent - 4) << SUB_BUCKET_BITS) + subBucket;
+	}
+
+	return result;
+}
+
+uint32_t LatencyHistogram::getBucketUpperBound(unsigned bucket)
+{
+	uint32_t result = bucket;
+
+	if (bucket >= LINEAR_BUCKETS)
+	{
+		unsigned exponent = 4 + ((bucket - LINEAR_BUCKETS) >> SUB_BUCKET_BITS);
+		unsigned subBucket = (bucket - LINEAR_BUCKETS) & ((1 << SUB_BUCKET_BITS) - 1);
+		unsigned shift = exponent - SUB_BUCKET_BITS;
+
+		uint64_t upper = ((uint64_t)((1 << SUB_BUCKET_BITS) + subBucket + 1) << shift) - 1;
+		result = upper > UINT32_MAX ? UINT32_MAX : (uint32_t)upper;
+	}
+
+	return result;
+}
+
+// LatencyTracer class
+
+LatencyTracer& LatencyTracer::instance()
+{
+	static LatencyTracer instance;
+
+	return instance;
+}
+
+bool LatencyTracer::isEnabled()
+{
+	return m_enabled;
+}
+
+void LatencyTracer::setEnabled(bool enabled)
+{
+	m_enabled = enabled;
+}
+
+void LatencyTracer::record(const string& device, LatencyStageEnum stage, uint64_t timestamp)
+{
+	if (!m_enabled || timestamp == 0)
+		return;
+
+	record(device, stage, timestamp, now());
+}
+
+void LatencyTracer::record(const string& device, LatencyStageEnum stage, uint64_t timestamp, uint64_t now)
+{
+	if (!m_enabled || timestamp == 0 || now < timestamp)
+		return;
+
+	// Skip samples from devices with realtime clock (EVIOCSCLOCKID not supported by kernel)
+	uint64_t latency = now - timestamp;
+	if (latency > LATENCY_MAX_VALID)
+		return;
+
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexDevices);
+
+	m_devices[device].stages[stage._to_integral()].add((uint32_t)latency);
+}
+
+void LatencyTracer::reset()
+{
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexDevices);
+
+	m_devices.clear();
+}
+
+// Returns copy of stage histogram for the device (empty if no samples recorded)
+LatencyHistogram LatencyTracer::getHistogram(const string& device, LatencyStageEnum stage)
+{
+	LatencyHistogram result;
+
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexDevices);
+
+	auto it = m_devices.find(device);
+	if (it != m_devices.end())
+	{
+		result = it->second.stages[stage._to_integral()];
+	}
+
+	return result;
+}
+
+void LatencyTracer::report()
+{
+	string report = dump();
+
+	if (!report.empty())
+	{
+		LOGINFO("Input latency (us, measured from kernel event timestamp):\n%s", report.c_str());
+	}
+
+	m_lastReport = now();
+}
+
+// Dumps histograms into the log each LATENCY_REPORT_INTERVAL if new samples were collected since last report
+void LatencyTracer::reportIfDue()
+{
+	if (!m_enabled)
+		return;
+
+	uint64_t current = now();
+	if (current - m_lastReport < (uint64_t)LATENCY_REPORT_INTERVAL * 1000)
+		return;
+
+	m_lastReport = current;
+
+	bool hasNewSamples = false;
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexDevices);
+
+		for (auto& it : m_devices)
+		{
+			DeviceLatency& device = it.second;
+			uint32_t count = device.stages[LatencyStageEnum::Wakeup].getCount();
+
+			if (count != device.reported)
+			{
+				device.reported = count;
+				hasNewSamples = true;
+			}
+		}
+	}
+
+	if (hasNewSamples)
+	{
+		report();
+	}
+}
+
+// Time helpers
+uint64_t LatencyTracer::now()
+{
+	timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	uint64_t result = (uint64_t)time.tv_sec * 1000000 + time.tv_nsec / 1000;
+
+	return result;
+}
+
+uint64_t LatencyTracer::toMicroseconds(const timeval& time)
+{
+	uint64_t result = (uint64_t)time.tv_sec * 1000000 + time.tv_usec;
+
+	return result;
+}
+
+// Debug methods
+string LatencyTracer::dump()
+{
+	stringstream ss;
+
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexDevices);
+
+	for (auto& it : m_devices)
+	{
+		const DeviceLatency& device = it.second;
+
+		ss << tfm::format("  %s:", it.first.c_str()) << endl;
+
+		for (LatencyStageEnum stage : LatencyStageEnum::_values())
+		{
+			const LatencyHistogram& histogram = device.stages[stage._to_integral()];
+			if (histogram.getCount() == 0)
+				continue;
+
+			ss << tfm::format("    %-9s count: %-8u p50: %-6u p99: %-6u max: %u",
+				stage._to_string(), histogram.getCount(), histogram.getPercentile(50), histogram.getPercentile(99), histogram.getMax()) << endl;
+		}
+	}
+
+	return ss.str();
+}
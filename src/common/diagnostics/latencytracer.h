@@ -0,0 +1,99 @@
+#ifndef COMMON_DIAGNOSTICS_LATENCYTRACER_H_
+#define COMMON_DIAGNOSTICS_LATENCYTRACER_H_
+
+#include <stdint.h>
+#include <sys/time.h>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include "../consts.h"
+#include "../types.h"
+
+using namespace std;
+
+// Log-linear histogram for latency values (in microseconds)
+// Values below 16us have own buckets, each power of 2 above is split into 8 sub-buckets (precision ~12.5%)
+// Adding sample is O(1) and allocation-free, so it's safe to use from input polling thread
+class LatencyHistogram
+{
+public:
+	static constexpr unsigned LINEAR_BUCKETS = 16;
+	static constexpr unsigned SUB_BUCKET_BITS = 3;
+	static constexpr unsigned BUCKETS = LINEAR_BUCKETS + (32 - 4) * (1 << SUB_BUCKET_BITS);
+
+protected:
+	uint32_t m_buckets[BUCKETS];
+	uint32_t m_count = 0;
+	uint32_t m_max = 0;
+
+public:
+	LatencyHistogram();
+
+	void add(uint32_t value);
+	void reset();
+
+	uint32_t getCount() const;
+	uint32_t getMax() const;
+	uint32_t getPercentile(unsigned percent) const;
+
+// Helper methods
+protected:
+	static unsigned getBucket(uint32_t value);
+	static uint32_t getBucketUpperBound(unsigned bucket);
+};
+
+// Latency histograms for all pipeline stages of a single input device
+struct DeviceLatency
+{
+	LatencyHistogram stages[LatencyStageEnum::_size_constant];
+	uint32_t reported = 0;		// Number of samples at the moment of last report
+};
+typedef struct DeviceLatency DeviceLatency;
+typedef map<string, DeviceLatency> DeviceLatencyMap;
+
+// Collects end-to-end input latency per device.
+// Each stage sample is measured from the kernel event timestamp (input_event.time, CLOCK_MONOTONIC) to the moment stage completed.
+// Disabled by default (diagnostics only): input load generator and debug code enable it explicitly
+class LatencyTracer
+{
+protected:
+	atomic<bool> m_enabled;
+
+	mutex m_mutexDevices;
+	DeviceLatencyMap m_devices;
+
+	uint64_t m_lastReport = 0;
+
+public:
+	// Singleton instance
+	static LatencyTracer& instance();
+	LatencyTracer(LatencyTracer&&) = delete;						// Disable move constructor (C++11 feature)
+	LatencyTracer(const LatencyTracer& that) = delete; 			// Disable copy constructor (C++11 feature)
+	LatencyTracer& operator =(LatencyTracer const&) = delete;		// Disable assignment operator (C++11 feature)
+	virtual ~LatencyTracer() {};
+
+public:
+	bool isEnabled();
+	void setEnabled(bool enabled);
+
+	void record(const string& device, LatencyStageEnum stage, uint64_t timestamp);
+	void record(const string& device, LatencyStageEnum stage, uint64_t timestamp, uint64_t now);
+	void reset();
+	LatencyHistogram getHistogram(const string& device, LatencyStageEnum stage);
+
+	void report();
+	void reportIfDue();
+
+	// Time helpers (all values in microseconds, CLOCK_MONOTONIC)
+	static uint64_t now();
+	static uint64_t toMicroseconds(const timeval& time);
+
+	// Debug methods
+	string dump();
+
+private:
+	LatencyTracer() { m_enabled = false; };	// Disable explicit object creation (only singleton instance allowed)
+};
+
+#endif /* COMMON_DIAGNOSTICS_LATENCYTRACER_H_ */
@@ -415,11 +415,15 @@ void EventQueue::processEvent(EventMessageBase& event)
 	EventFunctors fObservers;
 
 	// Locked access to collection of subscribers
+	// Topic can have plain observers, functor observers or both - collections are checked independently
 	unique_lock<mutex> lock(m_mutexObservers);
 	if (key_exists(m_observers, name))
 	{
 		// Make local copy not to block observers collection(s) access for a long
 		observers = m_observers[name];
+	}
+	if (key_exists(m_fObservers, name))
+	{
 		fObservers = m_fObservers[name];
 	}
 	lock.unlock();
@@ -447,7 +451,7 @@ void EventQueue::processEvent(EventMessageBase& event)
 
 		//DEBUG("%s: Event for topic '%s' processing finished. Observers served: %d, errors: %d\n", __PRETTY_FUNCTION__, name.c_str(), observersProcessed, errorCount);
 	}
-	else
+	else if (fObservers.size() == 0)
 	{
 		LOGWARN("%s: No subscribers for topic '%s'. Dropping the message\n", __PRETTY_FUNCTION__, name.c_str());
 	}
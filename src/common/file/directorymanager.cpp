@@ -10,6 +10,7 @@
 
 #include "../../3rdparty/openbsd/string.h"
 #include "../file/filemanager.h"
+#include "../file/scandir/directoryindex.h"
 #include "../system/sysmanager.h"
 
 CharStringSet* DirectoryManager::fileExclusions = new CharStringSet();
@@ -69,6 +70,24 @@ DirectoryListPtr DirectoryManager::scanDirectory(
 	// Create full absolute path
 	snprintf(fullPath, sizeof(fullPath), "%s/%s", sysmanager::getDataRootDir(), folderPath);
 
+	// Unchanged folder is listed from its index (display names depend on <withExtensions> only, so they're not indexed)
+	string indexKey = getIndexKey(supportedExtensions, includeFolders);
+	struct stat info;
+	bool isIndexed = DirectoryIndex::getFolderInfo(fullPath, info);
+
+	DirectoryIndex index;
+	if (isIndexed && index.open(fullPath, indexKey))
+	{
+		for (uint32_t i = 0; i < index.getCount(); i++)
+		{
+			list->emplace_back(createEntry(index.getName(i), index.isFolder(i), withExtensions));
+		}
+
+		return result;
+	}
+
+	DirectoryIndexWriter indexWriter;
+
 	DIR *dir = opendir(fullPath);
 	if (dir != nullptr)
 	{
@@ -89,12 +108,8 @@ DirectoryListPtr DirectoryManager::scanDirectory(
 
 					if (includeFolders && isFileAllowed(de->d_name))
 					{
-						DirectoryEntryChar* item = new DirectoryEntryChar();
-						item->isFolder = true;
-						strlcpy(item->name, de->d_name, sizeof(item->name));
-						strlcpy(item->displayname, de->d_name, sizeof(item->displayname));
-
-						list->emplace_back(item);
+						list->emplace_back(createEntry(de->d_name, true, withExtensions));
+						indexWriter.add(de->d_name, true);
 					}
 					break;
 				case DT_REG:		// Current entry is regular file
@@ -102,19 +117,8 @@ DirectoryListPtr DirectoryManager::scanDirectory(
 					{
 						if (isFileMatchExtension(de->d_name, supportedExtensions))
 						{
-							DirectoryEntryChar* item = new DirectoryEntryChar();
-							strlcpy(item->name, de->d_name, sizeof(item->name));
-
-							if (withExtensions)
-							{
-								strlcpy(item->displayname, de->d_name, sizeof(item->displayname));
-							}
-							else
-							{
-								strlcpy(item->displayname, filemanager::getName(de->d_name).c_str(), sizeof(item->displayname));
-							}
-
-							list->emplace_back(item);
+							list->emplace_back(createEntry(de->d_name, false, withExtensions));
+							indexWriter.add(de->d_name, false);
 						}
 					}
 					break;
@@ -126,6 +130,11 @@ DirectoryListPtr DirectoryManager::scanDirectory(
 		}
 
 		closedir(dir);
+
+		if (isIndexed)
+		{
+			indexWriter.save(fullPath, indexKey, info);
+		}
 	}
 	else
 	{
@@ -137,6 +146,49 @@ DirectoryListPtr DirectoryManager::scanDirectory(
 
 // Helper methods
 
+DirectoryEntryChar* DirectoryManager::createEntry(const char* name, bool isFolder, bool withExtensions)
+{
+	DirectoryEntryChar* result = new DirectoryEntryChar();
+	result->isFolder = isFolder;
+	strlcpy(result->name, name, sizeof(result->name));
+
+	if (isFolder || withExtensions)
+	{
+		strlcpy(result->displayname, name, sizeof(result->displayname));
+	}
+	else
+	{
+		strlcpy(result->displayname, filemanager::getName(name).c_str(), sizeof(result->displayname));
+	}
+
+	return result;
+}
+
+// Folder index key for filter combination. Extensions set is ordered by pointers, so it's sorted here explicitly
+string DirectoryManager::getIndexKey(CharStringSet* extensions, bool includeFolders)
+{
+	string result = includeFolders ? "dm:folders:" : "dm:files:";
+
+	vector<string> values;
+	if (extensions != nullptr)
+	{
+		for (const char* extension : *extensions)
+		{
+			string value = extension;
+			transform(value.begin(), value.end(), value.begin(), ::tolower);
+			values.push_back(value);
+		}
+	}
+	sort(values.begin(), values.end());
+
+	for (const string& value : values)
+	{
+		result += value + ",";
+	}
+
+	return result;
+}
+
 bool DirectoryManager::isFileAllowed(const string& filename)
 {
 	bool result = isFileAllowed(filename.c_str());
@@ -7,6 +7,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "../types.h"
 
@@ -61,6 +62,9 @@ private:
 	// Static class, disallow objects creation
 	DirectoryManager();
 
+	static DirectoryEntryChar* createEntry(const char* name, bool isFolder, bool withExtensions);
+	static string getIndexKey(CharStringSet* extensions, bool includeFolders);
+
 	static bool isFileAllowed(const string& filename);
 	static bool isFileAllowed(const char *filename);
 	static bool isFileMatchExtension(const string&, CharStringSet* extensions);
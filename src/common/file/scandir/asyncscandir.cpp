@@ -0,0 +1,322 @@
+#include "asyncscandir.h"
+
+#include "../../logger/logger.h"
+
+#include <string.h>
+#include <strings.h>
+#include <algorithm>
+#include "../../consts.h"
+#include "../../messagetypes.h"
+#include "../../events/messagecenter.h"
+#include "../../helpers/collationsort.h"
+#include "../../timer/timerservice.h"
+#include "directoryindex.h"
+
+AsyncScanDir::~AsyncScanDir()
+{
+	cancel();
+}
+
+// Start scanning <path> in background (previous scan is cancelled). Returns scan identifier
+// <indexKey> (if set) has to identify <filter> and <sort> combination
+uint32_t AsyncScanDir::start(const string& path, filter_func filter, entry_sort_func sort, const string& indexKey)
+{
+	cancel();
+
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexEntries);
+
+		m_pending.clear();
+		m_sorted.clear();
+		m_isSorted = false;
+	}
+
+	m_path = path;
+	m_filter = filter;
+	m_sort = sort;
+	m_indexKey = indexKey;
+	m_isNotified = false;
+	m_isCompleted = false;
+
+	uint32_t result = ++m_scanId;
+	m_runningScanId = result;
+
+	Runnable::start();
+
+	return result;
+}
+
+// Stop scanning (waits for the thread, sorting of huge folder is the longest uninterruptible step)
+void AsyncScanDir::cancel()
+{
+	if (!m_stopped)
+	{
+		// Notifications already in the queue are recognized as stale by scan id
+		m_scanId++;
+
+		stop();
+	}
+}
+
+uint32_t AsyncScanDir::getScanId()
+{
+	return m_scanId;
+}
+
+bool AsyncScanDir::isCompleted()
+{
+	return m_isCompleted;
+}
+
+// Append entries read since previous fetch to <entries> (order of already fetched entries is not changed)
+bool AsyncScanDir::fetchEntries(DirectoryEntryVector& entries)
+{
+	bool result = false;
+
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexEntries);
+
+	m_isNotified = false;
+
+	if (!m_pending.empty())
+	{
+		entries.insert(entries.end(), make_move_iterator(m_pending.begin()), make_move_iterator(m_pending.end()));
+		m_pending.clear();
+
+		result = true;
+	}
+
+	return result;
+}
+
+// Replace <entries> with final sorted result (available once scan is completed)
+bool AsyncScanDir::fetchSorted(DirectoryEntryVector& entries)
+{
+	bool result = false;
+
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexEntries);
+
+	m_isNotified = false;
+
+	if (m_isSorted)
+	{
+		entries.swap(m_sorted);
+		m_sorted.clear();
+		m_pending.clear();
+		m_isSorted = false;
+
+		result = true;
+	}
+
+	return result;
+}
+
+// Collation key is prepared once per entry, entries are moved into sorted order after that
+void AsyncScanDir::sortNatural(DirectoryEntryVector& entries)
+{
+	CollationSort collation;
+	collation.reserve(entries.size());
+	for (const DirectoryEntry& entry : entries)
+	{
+		collation.add(entry.name);
+	}
+	collation.sort();
+
+	DirectoryEntryVector sorted;
+	sorted.reserve(entries.size());
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		sorted.push_back(move(entries[collation.getItemIndex(i)]));
+	}
+
+	entries.swap(sorted);
+}
+
+// Helper methods
+
+// Make entries read since the last publish available for fetchEntries()
+void AsyncScanDir::publish(DirectoryEntryVector& entries, size_t& published)
+{
+	if (published >= entries.size())
+		return;
+
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexEntries);
+
+		m_pending.insert(m_pending.end(), entries.begin() + published, entries.end());
+	}
+
+	published = entries.size();
+
+	notify(published, false);
+}
+
+// Make final (sorted) listing available for fetchSorted()
+void AsyncScanDir::complete(DirectoryEntryVector& entries, size_t count)
+{
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexEntries);
+
+		m_sorted.swap(entries);
+		m_isSorted = true;
+	}
+
+	m_isCompleted = true;
+
+	if (!m_stop)
+	{
+		notify(count, true);
+	}
+}
+
+// Consumer may be slower than scanner - only one progress notification is kept in the queue
+void AsyncScanDir::notify(uint32_t count, bool isCompleted)
+{
+	if (isCompleted || !m_isNotified.exchange(true))
+	{
+		MessageCenter::defaultCenter().post(EVENT_FOLDER_SCAN, this, new FolderScanEvent(m_runningScanId, count, isCompleted));
+	}
+}
+
+// Sorted listings are compared entry by entry (index stores names and folder flags only)
+bool AsyncScanDir::isSameListing(const DirectoryEntryVector& lhs, const DirectoryEntryVector& rhs)
+{
+	bool result = lhs.size() == rhs.size() && equal(lhs.begin(), lhs.end(), rhs.begin(),
+		[](const DirectoryEntry& left, const DirectoryEntry& right)
+		{
+			return left.isFolder == right.isFolder && left.name == right.name;
+		}
+	);
+
+	return result;
+}
+
+// Runnable override method(s)
+
+// Async thread body
+void AsyncScanDir::run()
+{
+	LOGINFO("AsyncScanDir: scanning '%s' in thread with tid: %d (0x%x)", m_path.c_str(), m_thread_id, m_thread_id);
+
+	uint64_t started = TimerService::now();
+	DirectoryEntryVector entries;
+	size_t published = 0;
+
+	// Folder state is taken before the scan, so changes made during the scan will invalidate the index
+	struct stat info;
+	bool isIndexed = !m_indexKey.empty() && DirectoryIndex::getFolderInfo(m_path, info);
+
+	// Index is served right away, but folder is rescanned anyway: FAT doesn't reflect every change in folder mtime / size
+	// (root folder has no timestamps at all, folder size grows by whole clusters only)
+	DirectoryEntryVector indexed;
+	bool isFromIndex = isIndexed && DirectoryIndex::load(m_path, m_indexKey, entries);
+	if (isFromIndex)
+	{
+		indexed = entries;
+
+		size_t count = entries.size();
+		complete(entries, count);
+
+		LOGINFO("AsyncScanDir: '%s' read from index in %llu ms, %d entries", m_path.c_str(), TimerService::now() - started, count);
+	}
+
+	DIR* dir = opendir(m_path.c_str());
+	if (dir == nullptr)
+	{
+		LOGWARN("%s: unable to open folder '%s': %s", __PRETTY_FUNCTION__, m_path.c_str(), logger::geterror());
+
+		isIndexed = false;
+	}
+	else
+	{
+		uint64_t lastPublish = started;
+		size_t batchSize = SCAN_FIRST_BATCH_SIZE;
+
+		while (!m_stop)
+		{
+			struct dirent* ent = readdir(dir);
+			if (ent == nullptr)
+				break;
+
+			if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0)
+				continue;
+
+			if (m_filter != nullptr && !m_filter(ent))
+				continue;
+
+			DirectoryEntry entry;
+			entry.name = ent->d_name;
+			entry.displayname = entry.name.substr(0, DirectoryEntry::DISPLAY_NAME_SIZE);
+			entry.isFolder = ent->d_type == DT_DIR;
+			entries.push_back(move(entry));
+
+			// Listing from index is already shown - nothing is published till the scan is compared with it
+			if (isFromIndex)
+				continue;
+
+			// First screen is shown right away, then batches are sent not too often to keep UI responsive
+			uint64_t now = TimerService::now();
+			if (entries.size() - published >= batchSize || now - lastPublish >= SCAN_BATCH_INTERVAL)
+			{
+				publish(entries, published);
+
+				batchSize = SCAN_BATCH_SIZE;
+				lastPublish = now;
+			}
+		}
+
+		closedir(dir);
+	}
+
+	if (m_stop)
+	{
+		LOGINFO("AsyncScanDir: scan of '%s' cancelled after %d entries", m_path.c_str(), entries.size());
+		return;
+	}
+
+	if (!isFromIndex)
+	{
+		publish(entries, published);
+	}
+
+	if (m_sort)
+	{
+		m_sort(entries);
+	}
+
+	if (isFromIndex)
+	{
+		if (isSameListing(indexed, entries))
+		{
+			LOGINFO("AsyncScanDir: '%s' rescanned in %llu ms, index is up to date", m_path.c_str(), TimerService::now() - started);
+			return;
+		}
+
+		// Changed listing replaces the one from index
+		published = entries.size();
+	}
+
+	// Entries are copied to index writer before moving them out to consumer, file is written after consumer is notified
+	DirectoryIndexWriter index;
+	if (isIndexed)
+	{
+		index.reserve(entries.size());
+		for (const DirectoryEntry& entry : entries)
+		{
+			index.add(entry);
+		}
+	}
+
+	complete(entries, published);
+
+	if (isIndexed && !m_stop)
+	{
+		index.save(m_path, m_indexKey, info);
+	}
+
+	LOGINFO("AsyncScanDir: '%s' scanned in %llu ms, %d entries", m_path.c_str(), TimerService::now() - started, published);
+}
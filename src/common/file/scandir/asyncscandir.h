@@ -0,0 +1,101 @@
+#ifndef COMMON_FILE_SCANDIR_ASYNCSCANDIR_H_
+#define COMMON_FILE_SCANDIR_ASYNCSCANDIR_H_
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include "../../types.h"
+#include "../../events/events.h"
+#include "../../thread/runnable.h"
+#include "scandir.h"
+
+using namespace std;
+
+// Sorts the whole list at once (allows to prepare sort keys once per entry instead of each comparison)
+typedef function<void(DirectoryEntryVector&)> entry_sort_func;
+
+/*
+ * Background folder scanner. Entries are read with readdir (no full scandir + sort before anything is shown)
+ * and published in batches: consumer is notified with EVENT_FOLDER_SCAN (FolderScanEvent) via MessageCenter,
+ * so fetch happens on the event dispatch thread. Once the folder is read, entries are sorted in background
+ * and the sorted list replaces unsorted one (final notification has isCompleted flag set).
+ * Scan can be cancelled at any moment (e.g. user left the folder) - no notifications are sent after that.
+ * With <indexKey> set, unchanged folder is read from its index (see DirectoryIndex) and reported as completed right away,
+ * changed folder is scanned as usual and index is rebuilt. Indexed folder is still rescanned in background: if listing
+ * differs from the index, consumer gets one more completed notification with the new listing and index is rewritten.
+ * Example:
+ *		scanner.start(path, ScanDir::getFPGACoreFilter(), AsyncScanDir::getNaturalSort());
+ *		<on EVENT_FOLDER_SCAN with matching scanId>: isCompleted ? scanner.fetchSorted(entries) : scanner.fetchEntries(entries);
+ */
+class AsyncScanDir : public Runnable, public EventSource
+{
+protected:
+	string m_path;
+	filter_func m_filter = nullptr;
+	entry_sort_func m_sort;
+	string m_indexKey;
+	atomic<uint32_t> m_scanId { 0 };
+	uint32_t m_runningScanId = 0;		// Scan id the thread was started with (used in notifications)
+
+	// Published data (guarded by m_mutexEntries)
+	mutex m_mutexEntries;
+	DirectoryEntryVector m_pending;		// Read, but not fetched yet
+	DirectoryEntryVector m_sorted;		// Final result
+	bool m_isSorted = false;
+
+	atomic<bool> m_isNotified;			// Notification is in the queue - no need to post another one
+	atomic<bool> m_isCompleted;
+
+public:
+	AsyncScanDir() : Runnable("dir_scan"), m_isNotified(false), m_isCompleted(false) {};
+	virtual ~AsyncScanDir();
+
+	uint32_t start(const string& path, filter_func filter = nullptr, entry_sort_func sort = nullptr, const string& indexKey = "");
+	void cancel();
+
+	uint32_t getScanId();
+	bool isCompleted();
+
+	bool fetchEntries(DirectoryEntryVector& entries);
+	bool fetchSorted(DirectoryEntryVector& entries);
+
+	//============= Default sorters =====================
+
+	static entry_sort_func getAlphaSortCaseInsensitive()
+	{
+		return [](DirectoryEntryVector& entries)
+		{
+			stable_sort(entries.begin(), entries.end(),
+				[](const DirectoryEntry& lhs, const DirectoryEntry& rhs) -> bool
+				{
+					return strcasecmp(lhs.name.c_str(), rhs.name.c_str()) < 0;
+				});
+		};
+	}
+
+	// Case-insensitive, numbers are compared by value ("Game 2" goes before "Game 10")
+	static entry_sort_func getNaturalSort()
+	{
+		return sortNatural;
+	}
+
+	static void sortNatural(DirectoryEntryVector& entries);
+
+// Helper methods
+protected:
+	void publish(DirectoryEntryVector& entries, size_t& published);
+	void complete(DirectoryEntryVector& entries, size_t count);
+	void notify(uint32_t count, bool isCompleted);
+
+	static bool isSameListing(const DirectoryEntryVector& lhs, const DirectoryEntryVector& rhs);
+
+// Runnable override method(s)
+protected:
+	// Async thread body
+	void run();
+};
+
+#endif /* COMMON_FILE_SCANDIR_ASYNCSCANDIR_H_ */
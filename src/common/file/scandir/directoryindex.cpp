@@ -0,0 +1,376 @@
+#include "directoryindex.h"
+
+#include "../../logger/logger.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "../../consts.h"
+#include "../../file/path/path.h"
+#include "../../system/sysmanager.h"
+
+#define DIRECTORY_INDEX_MAGIC "MDIX"
+#define DIRECTORY_INDEX_VERSION 1
+
+// Out-of-class definitions for constants (required for C++14 if constant is odr-used)
+constexpr uint16_t DirectoryIndex::FLAG_FOLDER;
+
+// Path and key block is padded, so entries array stays aligned
+static inline size_t align8(size_t size)
+{
+	return (size + 7) & ~(size_t)7;
+}
+
+// DirectoryIndex class
+
+DirectoryIndex::~DirectoryIndex()
+{
+	close();
+}
+
+// Map index file for <folder> / <key>. Fails if there is no index or folder was changed since index creation
+bool DirectoryIndex::open(const string& folder, const string& key)
+{
+	bool result = false;
+
+	close();
+
+	struct stat info;
+	if (!getFolderInfo(folder, info))
+		return result;
+
+	string path = getIndexFilePath(folder, key);
+
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd == INVALID_FILE_DESCRIPTOR)
+		return result;
+
+	struct stat fileInfo;
+	if (fstat(fd, &fileInfo) == 0 && fileInfo.st_size >= (off_t)sizeof(DirectoryIndexHeader))
+	{
+		void* data = mmap(nullptr, fileInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED)
+		{
+			m_data = (uint8_t*)data;
+			m_size = fileInfo.st_size;
+
+			result = validate(folder, key, info);
+		}
+	}
+
+	// Mapping stays valid after descriptor is closed
+	::close(fd);
+
+	if (!result)
+	{
+		DEBUG("%s: no valid index for '%s' (%s)", __PRETTY_FUNCTION__, folder.c_str(), key.c_str());
+
+		close();
+	}
+
+	return result;
+}
+
+void DirectoryIndex::close()
+{
+	if (m_data != nullptr)
+	{
+		munmap(m_data, m_size);
+	}
+
+	m_data = nullptr;
+	m_size = 0;
+	m_entries = nullptr;
+	m_names = nullptr;
+	m_count = 0;
+}
+
+bool DirectoryIndex::isOpen()
+{
+	return m_data != nullptr;
+}
+
+uint32_t DirectoryIndex::getCount()
+{
+	return m_count;
+}
+
+// Name pointer is valid while index is open
+const char* DirectoryIndex::getName(uint32_t index)
+{
+	const char* result = index < m_count ? m_names + m_entries[index].nameOffset : nullptr;
+
+	return result;
+}
+
+uint16_t DirectoryIndex::getNameLength(uint32_t index)
+{
+	uint16_t result = index < m_count ? m_entries[index].nameLength : 0;
+
+	return result;
+}
+
+bool DirectoryIndex::isFolder(uint32_t index)
+{
+	bool result = index < m_count && (m_entries[index].flags & FLAG_FOLDER);
+
+	return result;
+}
+
+// Append all indexed entries to <entries>
+void DirectoryIndex::read(DirectoryEntryVector& entries)
+{
+	entries.reserve(entries.size() + m_count);
+
+	for (uint32_t i = 0; i < m_count; i++)
+	{
+		const DirectoryIndexEntry& item = m_entries[i];
+
+		DirectoryEntry entry;
+		entry.name.assign(m_names + item.nameOffset, item.nameLength);
+		entry.displayname = entry.name.substr(0, DirectoryEntry::DISPLAY_NAME_SIZE);
+		entry.isFolder = item.flags & FLAG_FOLDER;
+
+		entries.push_back(move(entry));
+	}
+}
+
+// Replace <entries> with indexed listing of <folder>. Returns false if there is no valid index (folder needs to be scanned)
+bool DirectoryIndex::load(const string& folder, const string& key, DirectoryEntryVector& entries)
+{
+	bool result = false;
+
+	DirectoryIndex index;
+	if (index.open(folder, key))
+	{
+		entries.clear();
+		index.read(entries);
+
+		result = true;
+	}
+
+	return result;
+}
+
+// <info> should be taken before the scan: if folder is changed during the scan, index will be outdated right away
+bool DirectoryIndex::save(const string& folder, const string& key, const DirectoryEntryVector& entries, const struct stat& info)
+{
+	DirectoryIndexWriter writer;
+	writer.reserve(entries.size());
+
+	for (const DirectoryEntry& entry : entries)
+	{
+		writer.add(entry);
+	}
+
+	bool result = writer.save(folder, key, info);
+
+	return result;
+}
+
+bool DirectoryIndex::getFolderInfo(const string& folder, struct stat& info)
+{
+	bool result = stat(folder.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+
+	return result;
+}
+
+// Folder modified just now may be modified again within the same mtime tick - such state can't be trusted.
+// mtime in the future means the clock is behind (no RTC, time is not synced yet): age is unknown, folder is indexed
+bool DirectoryIndex::isIndexable(const struct stat& info)
+{
+	time_t age = time(nullptr) - info.st_mtime;
+	bool result = age < 0 || age >= DIRECTORY_INDEX_RACY_WINDOW;
+
+	return result;
+}
+
+// Index file name is a hash of folder path and key (both are stored in the file and verified on open)
+string DirectoryIndex::getIndexFilePath(const string& folder, const string& key)
+{
+	// FNV-1a (64-bit)
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	auto update = [&hash](const string& value)
+	{
+		for (unsigned char symbol : value)
+		{
+			hash = (hash ^ symbol) * 0x100000001b3ULL;
+		}
+
+		hash = hash * 0x100000001b3ULL;	// Separator, so "ab" + "c" != "a" + "bc"
+	};
+	update(folder);
+	update(key);
+
+	char fileName[32];
+	snprintf(fileName, sizeof(fileName), "%016llx.idx", (unsigned long long)hash);
+
+	string result = Path::combine(sysmanager::getDataRootDir(), CONFIG_DIR).combine(DIRECTORY_INDEX_DIR).combine(fileName).toString();
+
+	return result;
+}
+
+// Helper methods
+
+// Check mapped file structure and match with current folder state
+bool DirectoryIndex::validate(const string& folder, const string& key, const struct stat& info)
+{
+	bool result = false;
+
+	const DirectoryIndexHeader* header = (const DirectoryIndexHeader*)m_data;
+
+	if (memcmp(header->magic, DIRECTORY_INDEX_MAGIC, sizeof(header->magic)) != 0 || header->version != DIRECTORY_INDEX_VERSION)
+		return result;
+
+	// Folder changed since indexing
+	if (header->mtime != (int64_t)info.st_mtim.tv_sec ||
+		header->mtimeNsec != (int64_t)info.st_mtim.tv_nsec ||
+		header->folderSize != (int64_t)info.st_size)
+		return result;
+
+	// Sizes are checked one by one to avoid overflow in offsets calculation
+	if (header->count > m_size / sizeof(DirectoryIndexEntry) ||
+		header->pathLength > m_size || header->keyLength > m_size || header->namesSize > m_size)
+		return result;
+
+	size_t identityOffset = sizeof(DirectoryIndexHeader);
+	size_t entriesOffset = identityOffset + align8((size_t)header->pathLength + header->keyLength);
+	size_t namesOffset = entriesOffset + (size_t)header->count * sizeof(DirectoryIndexEntry);
+	if (header->pathLength != folder.size() || header->keyLength != key.size() ||
+		namesOffset + header->namesSize != m_size)
+		return result;
+
+	// Hash collision
+	const char* identity = (const char*)m_data + identityOffset;
+	if (memcmp(identity, folder.data(), folder.size()) != 0 ||
+		memcmp(identity + folder.size(), key.data(), key.size()) != 0)
+		return result;
+
+	m_entries = (const DirectoryIndexEntry*)(m_data + entriesOffset);
+	m_names = (const char*)m_data + namesOffset;
+	m_count = header->count;
+
+	// Damaged file should never produce reads outside of the mapping
+	result = true;
+	for (uint32_t i = 0; result && i < m_count; i++)
+	{
+		const DirectoryIndexEntry& entry = m_entries[i];
+		result = (size_t)entry.nameOffset + entry.nameLength < header->namesSize && m_names[entry.nameOffset + entry.nameLength] == '\0';
+	}
+
+	if (!result)
+	{
+		LOGWARN("%s: damaged index file '%s'", __PRETTY_FUNCTION__, getIndexFilePath(folder, key).c_str());
+	}
+
+	return result;
+}
+
+// DirectoryIndexWriter class
+
+void DirectoryIndexWriter::reserve(size_t count)
+{
+	m_entries.reserve(count);
+	m_names.reserve(count * 32);
+}
+
+void DirectoryIndexWriter::add(const char* name, bool isFolder)
+{
+	size_t length = strnlen(name, NAME_MAX);
+
+	DirectoryIndexEntry entry;
+	entry.nameOffset = m_names.size();
+	entry.nameLength = length;
+	entry.flags = isFolder ? DirectoryIndex::FLAG_FOLDER : 0;
+	m_entries.push_back(entry);
+
+	m_names.append(name, length);
+	m_names.push_back('\0');
+}
+
+void DirectoryIndexWriter::add(const DirectoryEntry& entry)
+{
+	add(entry.name.c_str(), entry.isFolder);
+}
+
+uint32_t DirectoryIndexWriter::getCount()
+{
+	return m_entries.size();
+}
+
+// Write collected entries as index of <folder> / <key>. <info> is folder state at the moment scan was started
+bool DirectoryIndexWriter::save(const string& folder, const string& key, const struct stat& info)
+{
+	bool result = false;
+
+	if (!DirectoryIndex::isIndexable(info))
+	{
+		DEBUG("%s: '%s' was modified just now, index is not saved", __PRETTY_FUNCTION__, folder.c_str());
+		return result;
+	}
+
+	string path = DirectoryIndex::getIndexFilePath(folder, key);
+	string tempPath = path + ".tmp";
+
+	string indexFolder = Path::combine(sysmanager::getDataRootDir(), CONFIG_DIR).combine(DIRECTORY_INDEX_DIR).toString();
+	if (mkdir(indexFolder.c_str(), S_IRWXU | S_IRWXG | S_IRWXO) != 0 && errno != EEXIST)
+	{
+		LOGWARN("%s: unable to create folder '%s': %s", __PRETTY_FUNCTION__, indexFolder.c_str(), logger::geterror());
+		return result;
+	}
+
+	DirectoryIndexHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, DIRECTORY_INDEX_MAGIC, sizeof(header.magic));
+	header.version = DIRECTORY_INDEX_VERSION;
+	header.mtime = info.st_mtim.tv_sec;
+	header.mtimeNsec = info.st_mtim.tv_nsec;
+	header.folderSize = info.st_size;
+	header.count = m_entries.size();
+	header.namesSize = m_names.size();
+	header.pathLength = folder.size();
+	header.keyLength = key.size();
+
+	// Whole file is assembled in memory and written with single call
+	string identity = folder + key;
+	identity.resize(align8(identity.size()), '\0');
+
+	string data;
+	data.reserve(sizeof(header) + identity.size() + m_entries.size() * sizeof(DirectoryIndexEntry) + m_names.size());
+	data.append((const char*)&header, sizeof(header));
+	data.append(identity);
+	data.append((const char*)m_entries.data(), m_entries.size() * sizeof(DirectoryIndexEntry));
+	data.append(m_names);
+
+	// Write into temporary file first, so power loss during write won't leave broken index
+	int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+	if (fd != INVALID_FILE_DESCRIPTOR)
+	{
+		bool isWritten = write(fd, data.data(), data.size()) == (ssize_t)data.size();
+		::close(fd);
+
+		if (isWritten && rename(tempPath.c_str(), path.c_str()) == 0)
+		{
+			result = true;
+		}
+		else
+		{
+			unlink(tempPath.c_str());
+		}
+	}
+
+	if (result)
+	{
+		DEBUG("%s: %d entries of '%s' indexed to '%s'", __PRETTY_FUNCTION__, m_entries.size(), folder.c_str(), path.c_str());
+	}
+	else
+	{
+		LOGWARN("%s: unable to save folder index to '%s': %s", __PRETTY_FUNCTION__, path.c_str(), logger::geterror());
+	}
+
+	return result;
+}
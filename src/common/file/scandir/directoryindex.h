@@ -0,0 +1,113 @@
+#ifndef COMMON_FILE_SCANDIR_DIRECTORYINDEX_H_
+#define COMMON_FILE_SCANDIR_DIRECTORYINDEX_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include "../../types.h"
+
+using namespace std;
+
+// Index file layout:
+//		DirectoryIndexHeader
+//		folder path + key (not null-terminated), padded to 8 bytes
+//		DirectoryIndexEntry[count]
+//		names pool (null-terminated names, referenced by entries)
+struct DirectoryIndexHeader
+{
+	char magic[4];
+	uint32_t version;
+	int64_t mtime;				// Folder state at the moment of scan
+	int64_t mtimeNsec;
+	int64_t folderSize;
+	uint32_t count;
+	uint32_t namesSize;
+	uint32_t pathLength;
+	uint32_t keyLength;
+};
+typedef struct DirectoryIndexHeader DirectoryIndexHeader;
+
+struct DirectoryIndexEntry
+{
+	uint32_t nameOffset;
+	uint16_t nameLength;
+	uint16_t flags;
+};
+typedef struct DirectoryIndexEntry DirectoryIndexEntry;
+
+/*
+ * Persistent folder listing: filtered and sorted entries are stored in a binary file (one per folder and <key>)
+ * together with folder mtime / size. While folder is not changed, listing is read with a single mmap instead of
+ * full folder scan (which takes seconds for big folders on FAT).
+ * <key> identifies filter and sort order used to build the listing, so different views of the same folder
+ * have separate indexes.
+ * Inode number is not checked: FAT / exFAT drivers assign inode numbers on each mount.
+ * Example:
+ *		struct stat info;
+ *		DirectoryIndex::getFolderInfo(path, info);		// Before the scan, so changes made during scan invalidate index
+ *		if (!DirectoryIndex::load(path, key, entries))
+ *		{
+ *			<scan folder>
+ *			DirectoryIndex::save(path, key, entries, info);
+ *		}
+ */
+class DirectoryIndex
+{
+public:
+	static constexpr uint16_t FLAG_FOLDER = 0x0001;
+
+protected:
+	uint8_t* m_data = nullptr;
+	size_t m_size = 0;
+
+	const DirectoryIndexEntry* m_entries = nullptr;
+	const char* m_names = nullptr;
+	uint32_t m_count = 0;
+
+public:
+	DirectoryIndex() {};
+	DirectoryIndex(DirectoryIndex&&) = delete;						// Disable move constructor (C++11 feature)
+	DirectoryIndex(const DirectoryIndex& that) = delete; 			// Disable copy constructor (C++11 feature)
+	DirectoryIndex& operator =(DirectoryIndex const&) = delete;		// Disable assignment operator (C++11 feature)
+	virtual ~DirectoryIndex();
+
+	bool open(const string& folder, const string& key);
+	void close();
+	bool isOpen();
+
+	uint32_t getCount();
+	const char* getName(uint32_t index);
+	uint16_t getNameLength(uint32_t index);
+	bool isFolder(uint32_t index);
+
+	void read(DirectoryEntryVector& entries);
+
+	static bool load(const string& folder, const string& key, DirectoryEntryVector& entries);
+	static bool save(const string& folder, const string& key, const DirectoryEntryVector& entries, const struct stat& info);
+	static bool getFolderInfo(const string& folder, struct stat& info);
+	static bool isIndexable(const struct stat& info);
+	static string getIndexFilePath(const string& folder, const string& key);
+
+// Helper methods
+protected:
+	bool validate(const string& folder, const string& key, const struct stat& info);
+};
+
+// Collects entries and writes index file (into temporary file first, then renamed)
+class DirectoryIndexWriter
+{
+protected:
+	vector<DirectoryIndexEntry> m_entries;
+	string m_names;
+
+public:
+	void reserve(size_t count);
+	void add(const char* name, bool isFolder);
+	void add(const DirectoryEntry& entry);
+	uint32_t getCount();
+
+	bool save(const string& folder, const string& key, const struct stat& info);
+};
+
+#endif /* COMMON_FILE_SCANDIR_DIRECTORYINDEX_H_ */
@@ -1,6 +1,7 @@
 #include "scandir.h"
 
 #include <stdlib.h>
+#include "directoryindex.h"
 
 // Performs folder specified by <path> scanning
 // Optional <filter> lambda can be used to filter out unneccessary entries
@@ -30,8 +31,41 @@ void ScanDir::scanFolder(const char* path, filter_func filter, compar_func compa
 	}
 }
 
+// Same as above, but listing is taken from folder index (see DirectoryIndex) if folder was not changed since the last scan.
+// Otherwise folder is scanned and index is rebuilt on getScanResults() call.
+// <indexKey> has to identify <filter> and <compar> combination (e.g. "fpga_cores")
+void ScanDir::scanFolder(const string& path, const string& indexKey, filter_func filter, compar_func compar)
+{
+	dispose();
+
+	// Folder state is taken before the scan, so changes made during the scan will invalidate the index
+	struct stat info;
+	bool hasInfo = DirectoryIndex::getFolderInfo(path, info);
+
+	if (hasInfo && DirectoryIndex::load(path, indexKey, _indexedEntries))
+	{
+		_isIndexed = true;
+		return;
+	}
+
+	scanFolder(path.c_str(), filter, compar);
+
+	// Failed (or empty, which is cheap to re-scan anyway) scan is not indexed
+	if (hasInfo && _nEntries > 0)
+	{
+		_path = path;
+		_indexKey = indexKey;
+		_folderInfo = info;
+	}
+}
+
 void ScanDir::dispose()
 {
+	_isIndexed = false;
+	_indexedEntries.clear();
+	_path.clear();
+	_indexKey.clear();
+
 	if (_nEntries > 0 && _entryList != nullptr)
 	{
 		void* ptr;
@@ -55,6 +89,14 @@ DirectoryEntryVector ScanDir::getScanResults()
 {
 	DirectoryEntryVector result;
 
+	if (_isIndexed)
+	{
+		result.swap(_indexedEntries);
+		_isIndexed = false;
+
+		return result;
+	}
+
 	if (_nEntries > 0 && _entryList != nullptr)
 	{
 		struct dirent* entry;
@@ -78,6 +120,12 @@ DirectoryEntryVector ScanDir::getScanResults()
 		_entryList = nullptr;
 	}
 
+	if (!_indexKey.empty())
+	{
+		DirectoryIndex::save(_path, _indexKey, result, _folderInfo);
+		_indexKey.clear();
+	}
+
 	return result;
 }
 
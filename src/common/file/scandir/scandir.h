@@ -8,8 +8,11 @@
 #include <string>
 #include <dirent.h>
 #include <fnmatch.h>
+#include <strings.h>
+#include <sys/stat.h>
 #include "../../consts.h"
 #include "../../types.h"
+#include "../../helpers/collationsort.h"
 
 using namespace std;
 
@@ -23,6 +26,13 @@ protected:
 	struct dirent** _entryList = nullptr;
 	int _nEntries = 0;
 
+	// Folder listing index (used only if index key is passed to scanFolder)
+	string _path;
+	string _indexKey;
+	struct stat _folderInfo;
+	bool _isIndexed = false;
+	DirectoryEntryVector _indexedEntries;
+
 public:
 	ScanDir()
 	{
@@ -45,6 +55,12 @@ public:
 		filter_func = nullptr,
 		compar_func = nullptr);
 
+	void scanFolder(
+		const string& path,
+		const string& indexKey,
+		filter_func = nullptr,
+		compar_func = nullptr);
+
 	void dispose();
 
 	DirectoryEntryVector getScanResults();
@@ -89,12 +105,16 @@ public:
 	{
 		return [](const struct dirent** dir1, const struct dirent** dir2) -> int
 		{
-			string str1((*dir1)->d_name);
-			string str2((*dir2)->d_name);
-			transform(str1.begin(), str1.end(), str1.begin(), ::tolower);
-			transform(str2.begin(), str2.end(), str2.begin(), ::tolower);
+			return strcasecmp((*dir1)->d_name, (*dir2)->d_name);
+		};
+	}
 
-			return str1.compare(str2);
+	// Case-insensitive, numbers are compared by value ("Game 2" goes before "Game 10")
+	static compar_func getNaturalSort()
+	{
+		return [](const struct dirent** dir1, const struct dirent** dir2) -> int
+		{
+			return CollationSort::compare((*dir1)->d_name, (*dir2)->d_name);
 		};
 	}
 
@@ -0,0 +1,217 @@
+#include "collationsort.h"
+
+#include <ctype.h>
+#include <string.h>
+#include <algorithm>
+
+// Digit runs longer than that are compared by first NUMBER_MAX_DIGITS significant digits only
+#define NUMBER_MAX_DIGITS 255
+
+static inline bool isDigit(unsigned char symbol)
+{
+	return symbol >= '0' && symbol <= '9';
+}
+
+// Skip leading zeros (at least one digit is kept) and measure significant part of the number
+static inline const unsigned char* scanNumber(const unsigned char* symbol, size_t& length)
+{
+	while (*symbol == '0' && isDigit(symbol[1]))
+	{
+		symbol++;
+	}
+
+	length = 0;
+	while (isDigit(symbol[length]))
+	{
+		length++;
+	}
+
+	return symbol;
+}
+
+void CollationSort::clear()
+{
+	m_keys.clear();
+	m_offsets.clear();
+	m_order.clear();
+}
+
+void CollationSort::reserve(size_t items, size_t averageLength)
+{
+	m_keys.reserve(items * (averageLength + 1));
+	m_offsets.reserve(items);
+	m_order.reserve(items);
+}
+
+void CollationSort::add(const string& name)
+{
+	add(name.c_str());
+}
+
+void CollationSort::add(const char* name)
+{
+	m_offsets.push_back(m_keys.size());
+	appendKey(m_keys, name);
+}
+
+// Items with equal keys (e.g. differ by letter case only) keep the order they were added in
+void CollationSort::sort()
+{
+	vector<SortItem> items(m_offsets.size());
+	for (uint32_t i = 0; i < items.size(); i++)
+	{
+		items[i].prefix = getPrefix(getItemKey(i));
+		items[i].item = i;
+	}
+
+	std::sort(items.begin(), items.end(),
+		[this](const SortItem& lhs, const SortItem& rhs)
+		{
+			if (lhs.prefix != rhs.prefix)
+				return lhs.prefix < rhs.prefix;
+
+			int result = strcmp(getItemKey(lhs.item), getItemKey(rhs.item));
+			if (result != 0)
+				return result < 0;
+
+			return lhs.item < rhs.item;
+		}
+	);
+
+	m_order.resize(items.size());
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		m_order[i] = items[i].item;
+	}
+}
+
+size_t CollationSort::size() const
+{
+	return m_offsets.size();
+}
+
+// Index of item (as it was added) located at <position> in sorted order
+int CollationSort::getItemIndex(int position) const
+{
+	int result = -1;
+
+	if (position >= 0 && position < (int)m_order.size())
+	{
+		result = m_order[position];
+	}
+
+	return result;
+}
+
+string CollationSort::getKey(const string& name)
+{
+	string result;
+	result.reserve(name.size() + 1);
+
+	appendKey(result, name.c_str());
+	result.pop_back();
+
+	return result;
+}
+
+// Natural case-insensitive comparison without keys (same order as keys give).
+// Suitable for per-comparison callbacks (scandir, qsort), no memory is allocated
+int CollationSort::compare(const char* lhs, const char* rhs)
+{
+	const unsigned char* left = (const unsigned char*)lhs;
+	const unsigned char* right = (const unsigned char*)rhs;
+
+	while (true)
+	{
+		bool isLeftDigit = isDigit(*left);
+		bool isRightDigit = isDigit(*right);
+
+		if (isLeftDigit && isRightDigit)
+		{
+			size_t leftLength, rightLength;
+			left = scanNumber(left, leftLength);
+			right = scanNumber(right, rightLength);
+
+			// Longer number is greater, numbers of the same length are compared digit by digit
+			size_t leftDigits = min(leftLength, (size_t)NUMBER_MAX_DIGITS);
+			size_t rightDigits = min(rightLength, (size_t)NUMBER_MAX_DIGITS);
+			if (leftDigits != rightDigits)
+				return (int)leftDigits - (int)rightDigits;
+
+			int result = memcmp(left, right, leftDigits);
+			if (result != 0)
+				return result;
+
+			left += leftLength;
+			right += rightLength;
+		}
+		else
+		{
+			// Number (of any length) is compared with other symbols as a single '0'
+			unsigned char leftSymbol = isLeftDigit ? '0' : tolower(*left);
+			unsigned char rightSymbol = isRightDigit ? '0' : tolower(*right);
+
+			if (leftSymbol != rightSymbol)
+				return (int)leftSymbol - (int)rightSymbol;
+
+			if (leftSymbol == '\0')
+				return 0;
+
+			left++;
+			right++;
+		}
+	}
+}
+
+// Helper methods
+
+// Key is a case-folded name with each number replaced by '0', its length and significant digits.
+// Lengths are compared before digits, so byte comparison orders numbers by value.
+// Key never contains '\0' (length is at least 1), so it's terminated the same way as name
+void CollationSort::appendKey(string& keys, const char* name)
+{
+	const unsigned char* symbol = (const unsigned char*)name;
+
+	while (*symbol != '\0')
+	{
+		if (isDigit(*symbol))
+		{
+			size_t length;
+			symbol = scanNumber(symbol, length);
+
+			size_t digits = min(length, (size_t)NUMBER_MAX_DIGITS);
+			keys.push_back('0');
+			keys.push_back((char)digits);
+			keys.append((const char*)symbol, digits);
+
+			symbol += length;
+		}
+		else
+		{
+			keys.push_back(tolower(*symbol));
+			symbol++;
+		}
+	}
+
+	keys.push_back('\0');
+}
+
+// Shorter keys are padded with zeros, so they go before longer ones with the same beginning
+uint64_t CollationSort::getPrefix(const char* key)
+{
+	uint64_t result = 0;
+
+	const unsigned char* symbol = (const unsigned char*)key;
+	for (int i = 0; i < 8; i++)
+	{
+		result <<= 8;
+
+		if (*symbol != '\0')
+		{
+			result |= *symbol;
+			symbol++;
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,53 @@
+#ifndef COMMON_HELPERS_COLLATIONSORT_H_
+#define COMMON_HELPERS_COLLATIONSORT_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Case-insensitive natural order sorting of names ("Game 2" goes before "Game 10").
+// Collation key is calculated once per name (instead of folding both names in each comparison), so plain byte
+// comparison of keys gives the required order. Keys are stored in a single '\0' separated pool, sorting is done
+// over compact (8 bytes key prefix, item index) pairs - most comparisons don't touch the pool at all
+class CollationSort
+{
+protected:
+	struct SortItem
+	{
+		uint64_t prefix;			// First 8 key bytes (big-endian, so integer comparison matches byte comparison)
+		uint32_t item;
+	};
+
+	string m_keys;					// Collation keys, each terminated by '\0'
+	vector<uint32_t> m_offsets;		// Key offset in m_keys (by item index)
+	vector<uint32_t> m_order;		// Item indexes in sorted order
+
+public:
+	void clear();
+	void reserve(size_t items, size_t averageLength = 32);
+
+	// Item index is the order of add() calls
+	void add(const string& name);
+	void add(const char* name);
+	void sort();
+
+	size_t size() const;
+	int getItemIndex(int position) const;
+
+	static string getKey(const string& name);
+	static int compare(const char* lhs, const char* rhs);
+
+// Helper methods
+protected:
+	inline const char* getItemKey(uint32_t item) const
+	{
+		return m_keys.c_str() + m_offsets[item];
+	}
+
+	static void appendKey(string& keys, const char* name);
+	static uint64_t getPrefix(const char* key);
+};
+
+#endif /* COMMON_HELPERS_COLLATIONSORT_H_ */
@@ -0,0 +1,123 @@
+#include "prefixindex.h"
+
+#include <ctype.h>
+#include <string.h>
+#include <algorithm>
+
+void PrefixIndex::clear()
+{
+	m_keys.clear();
+	m_offsets.clear();
+	m_order.clear();
+	m_isBuilt = false;
+}
+
+void PrefixIndex::reserve(size_t items, size_t averageLength)
+{
+	m_keys.reserve(items * (averageLength + 1));
+	m_offsets.reserve(items);
+	m_order.reserve(items);
+}
+
+void PrefixIndex::add(const string& name)
+{
+	m_offsets.push_back(m_keys.size());
+
+	for (char symbol : name)
+	{
+		m_keys.push_back(tolower((unsigned char)symbol));
+	}
+	m_keys.push_back('\0');
+
+	m_isBuilt = false;
+}
+
+// Names usually come already sorted (case-insensitive scan order), so sorting is skipped in that case
+void PrefixIndex::build()
+{
+	m_order.resize(m_offsets.size());
+	for (uint32_t idx = 0; idx < m_order.size(); idx++)
+	{
+		m_order[idx] = idx;
+	}
+
+	auto less = [this](uint32_t lhs, uint32_t rhs)
+	{
+		return strcmp(getKey(lhs), getKey(rhs)) < 0;
+	};
+
+	if (!is_sorted(m_order.begin(), m_order.end(), less))
+	{
+		stable_sort(m_order.begin(), m_order.end(), less);
+	}
+
+	m_isBuilt = true;
+}
+
+size_t PrefixIndex::size() const
+{
+	return m_order.size();
+}
+
+bool PrefixIndex::isBuilt() const
+{
+	return m_isBuilt;
+}
+
+// Keys are compared with the prefix only by prefix length, so all matching keys form one continuous range
+bool PrefixIndex::findRange(const string& prefix, int& first, int& last) const
+{
+	bool result = false;
+
+	first = 0;
+	last = 0;
+
+	if (!m_isBuilt)
+		return result;
+
+	string key = fold(prefix);
+	const char* value = key.c_str();
+	size_t length = key.size();
+
+	auto lower = lower_bound(m_order.begin(), m_order.end(), value,
+		[this, length](uint32_t item, const char* needle)
+		{
+			return strncmp(getKey(item), needle, length) < 0;
+		}
+	);
+
+	auto upper = upper_bound(lower, m_order.end(), value,
+		[this, length](const char* needle, uint32_t item)
+		{
+			return strncmp(needle, getKey(item), length) < 0;
+		}
+	);
+
+	first = lower - m_order.begin();
+	last = upper - m_order.begin();
+	result = last > first;
+
+	return result;
+}
+
+int PrefixIndex::getItemIndex(int position) const
+{
+	int result = -1;
+
+	if (position >= 0 && position < (int)m_order.size())
+	{
+		result = m_order[position];
+	}
+
+	return result;
+}
+
+string PrefixIndex::fold(const string& text)
+{
+	string result(text);
+
+	transform(result.begin(), result.end(), result.begin(),
+		[](char symbol) -> char { return tolower((unsigned char)symbol); });
+
+	return result;
+}
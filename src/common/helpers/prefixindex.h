@@ -0,0 +1,46 @@
+#ifndef COMMON_HELPERS_PREFIXINDEX_H_
+#define COMMON_HELPERS_PREFIXINDEX_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Case-insensitive prefix search over list of names (type-ahead in file / core browsers).
+// Folded keys are stored in a single '\0' separated pool, items are ordered by key once in build(),
+// so each lookup is O(log n) and doesn't allocate
+class PrefixIndex
+{
+protected:
+	string m_keys;					// Case-folded keys, each terminated by '\0'
+	vector<uint32_t> m_offsets;		// Key offset in m_keys (by item index)
+	vector<uint32_t> m_order;		// Item indexes sorted by key
+	bool m_isBuilt = false;
+
+public:
+	void clear();
+	void reserve(size_t items, size_t averageLength = 32);
+
+	// Item index is the order of add() calls
+	void add(const string& name);
+	void build();
+
+	size_t size() const;
+	bool isBuilt() const;
+
+	// Range of sorted positions [first, last) with keys starting from <prefix>. Returns false if nothing matches
+	bool findRange(const string& prefix, int& first, int& last) const;
+	int getItemIndex(int position) const;
+
+	static string fold(const string& text);
+
+// Helper methods
+protected:
+	inline const char* getKey(uint32_t item) const
+	{
+		return m_keys.c_str() + m_offsets[item];
+	}
+};
+
+#endif /* COMMON_HELPERS_PREFIXINDEX_H_ */
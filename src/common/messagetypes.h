@@ -40,7 +40,8 @@ typedef struct RelativeMoveEvent RelativeMoveEvent;
 
 struct AbsoluteMoveEvent
 {
-
+	uint16_t axis;		// EV_ABS code (ABS_X, ABS_Y, ABS_HAT0X etc.)
+	int32_t value;		// Raw (not calibrated) axis value as reported by device
 };
 typedef struct AbsoluteMoveEvent AbsoluteMoveEvent;
 
@@ -79,6 +80,9 @@ struct MInputMessage : public MessagePayloadBase
 	InputDeviceType deviceType = InputDeviceType::Unknown;
 	string name;
 
+	// Kernel timestamp of the first event in packet (microseconds, CLOCK_MONOTONIC). Used for latency tracing
+	uint64_t timestamp = 0;
+
 	MInputEvents events;
 };
 typedef struct MInputMessage MInputMessage;
@@ -93,6 +97,28 @@ struct DeviceStatusEvent: public MessagePayloadBase
 };
 typedef struct DeviceStatusEvent DeviceStatusEvent;
 
+// Generated by CommandCenter key repeat timer while key is held
+struct KeyRepeatEvent: public MessagePayloadBase
+{
+	uint16_t key;
+
+	KeyRepeatEvent(uint16_t key) : key(key) { };
+	virtual ~KeyRepeatEvent() { };
+};
+typedef struct KeyRepeatEvent KeyRepeatEvent;
+
+// Generated by AsyncScanDir when next batch of entries is available and when scan (including sorting) is completed
+struct FolderScanEvent: public MessagePayloadBase
+{
+	uint32_t scanId;		// To skip notifications from cancelled scans
+	uint32_t count;		// Entries read so far
+	bool isCompleted;
+
+	FolderScanEvent(uint32_t scanId, uint32_t count, bool isCompleted) : scanId(scanId), count(count), isCompleted(isCompleted) { };
+	virtual ~FolderScanEvent() { };
+};
+typedef struct FolderScanEvent FolderScanEvent;
+
 // Specific event, generated by CoreManager once FPGA core successfully started
 struct CoreStartedEvent: public MessagePayloadBase
 {
@@ -3,8 +3,8 @@
 #include "../../common/logger/logger.h"
 
 #include <pthread.h>
+#include <string.h>
 #include <unistd.h>
-#include <sys/prctl.h>
 #include <sys/syscall.h>
 
 Runnable::~Runnable()
@@ -26,7 +26,26 @@ void Runnable::start()
 		m_stopped = false;
 		m_stop = false;
 
-		m_thread = thread(&Runnable::threadStart, this);
+		// Stack size can be set on creation only
+		ThreadPolicy policy = getPolicy();
+
+		pthread_attr_t attr;
+		pthread_attr_init(&attr);
+		if (policy.stackSize != 0)
+		{
+			pthread_attr_setstacksize(&attr, policy.stackSize);
+		}
+
+		int status = pthread_create(&m_thread, &attr, &Runnable::threadEntry, this);
+		pthread_attr_destroy(&attr);
+
+		m_joinable = status == 0;
+		if (!m_joinable)
+		{
+			LOGERROR("Unable to start the thread {%s}: %s", m_name.c_str(), strerror(status));
+
+			m_stopped = true;
+		}
 	}
 	else
 	{
@@ -36,7 +55,8 @@ void Runnable::start()
 
 void Runnable::stop()
 {
-	if (m_thread_id < 0)
+	// Thread could be started, but not initialized its id yet (short-lived threads stopped right after start)
+	if (m_thread_id < 0 && !m_joinable)
 		return;
 
 	if (!m_stopped)
@@ -46,9 +66,10 @@ void Runnable::stop()
 		// Request thread to stop
 		m_stop = true;
 
-		if (m_thread.joinable())
+		if (m_joinable)
 		{
-			m_thread.join();
+			pthread_join(m_thread, nullptr);
+			m_joinable = false;
 		}
 
 		TRACE("Thread tid: 0x%d (0x%x) {%s} successfully stopped", m_thread_id, m_thread_id, m_name.c_str());
@@ -62,18 +83,35 @@ void Runnable::stop()
 	}
 }
 
+// Policy should be set before start() call to take effect
+void Runnable::setPolicy(const ThreadPolicy& policy)
+{
+	m_policy = policy;
+	m_hasPolicy = true;
+}
+
+ThreadPolicy Runnable::getPolicy()
+{
+	ThreadPolicy result = m_hasPolicy ? m_policy : ThreadPolicy::getDefault(m_name);
+
+	return result;
+}
+
+void* Runnable::threadEntry(void* runnable)
+{
+	((Runnable*)runnable)->threadStart();
+
+	return nullptr;
+}
+
 void Runnable::threadStart()
 {
 	// Get GDB compatible thread ID (gettid via syscall)
 	m_thread_id = syscall(SYS_gettid);
 	TRACE("Started new thread with tid: %d (0x%x) {%s}", m_thread_id, m_thread_id, m_name.c_str());
 
-	// Set thread name
-	if (m_name.size() > 0)
-	{
-		pthread_getname_np(m_thread.native_handle(), (char*)m_name.c_str(), m_name.size());
-		prctl(PR_SET_NAME, m_name.c_str(), 0, 0, 0);
-	}
+	// Set thread name, scheduling policy and CPU affinity
+	getPolicy().apply(m_name);
 
 	run();
 
@@ -2,21 +2,27 @@
 #define COMMON_THREAD_RUNNABLE_H_
 
 #include <atomic>
-#include <thread>
 #include <string>
+#include <pthread.h>
 #include <sys/types.h>
+#include "threadpolicy.h"
 
 using namespace std;
 
 class Runnable
 {
 protected:
-    thread m_thread;
+    pthread_t m_thread;         // pthread is used directly (instead of std::thread) to set stack size from policy
+    bool m_joinable = false;
     string m_name;
     pid_t m_thread_id = -1;
     atomic<bool> m_stop;
     atomic<bool> m_stopped;
 
+    // Scheduling policy applied on thread start (default profile by thread name is used if not set explicitly)
+    ThreadPolicy m_policy;
+    bool m_hasPolicy = false;
+
 public:
     Runnable() : m_thread(), m_name(), m_stop(false), m_stopped(true) {};
     Runnable(const string& name) : m_thread(), m_name(name), m_stop(false), m_stopped(true) {};
@@ -28,7 +34,11 @@ public:
     void start();
     void stop();
 
+    void setPolicy(const ThreadPolicy& policy);
+    ThreadPolicy getPolicy();
+
 protected:
+    static void* threadEntry(void* runnable);
     void threadStart();
     virtual void run() = 0;
 };
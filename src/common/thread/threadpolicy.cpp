@@ -0,0 +1,118 @@
+#include "threadpolicy.h"
+
+#include "../logger/logger.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include "../consts.h"
+#include "../../3rdparty/tinyformat/tinyformat.h"
+
+bool ThreadPolicy::apply(const string& name) const
+{
+	bool result = true;
+
+	// Set thread name (visible in top / gdb, limited to 15 characters by kernel)
+	if (name.size() > 0)
+	{
+		prctl(PR_SET_NAME, name.c_str(), 0, 0, 0);
+	}
+
+	// Pin thread to selected CPU(s)
+	if (affinity != 0)
+	{
+		cpu_set_t cpuSet;
+		CPU_ZERO(&cpuSet);
+
+		for (unsigned cpu = 0; cpu < 32; cpu++)
+		{
+			if (affinity & (1u << cpu))
+				CPU_SET(cpu, &cpuSet);
+		}
+
+		if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) != 0)
+		{
+			LOGWARN("%s: unable to set CPU affinity 0x%x for thread '%s'", __PRETTY_FUNCTION__, affinity, name.c_str());
+			result = false;
+		}
+	}
+
+	// Switch to real-time scheduling (requires root or CAP_SYS_NICE)
+	if (isRealtime())
+	{
+		sched_param param;
+		param.sched_priority = priority;
+
+		if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0)
+		{
+			LOGWARN("%s: unable to set SCHED_FIFO priority %d for thread '%s'", __PRETTY_FUNCTION__, priority, name.c_str());
+			result = false;
+		}
+	}
+
+	DEBUG("Thread '%s' policy applied: %s", name.c_str(), dump().c_str());
+
+	return result;
+}
+
+/*
+ * Memory locking is process-wide. It's requested once all long-living threads are started (initialization is done),
+ * so their stacks are locked too. MCL_FUTURE is not used: it would lock everything mapped later as well
+ * (file buffers, folder index mappings, default 8MB stacks of short-living threads)
+ */
+bool ThreadPolicy::lockMemory()
+{
+	bool result = mlockall(MCL_CURRENT) == 0;
+
+	if (!result)
+	{
+		LOGWARN("%s: mlockall failed: %s", __PRETTY_FUNCTION__, logger::geterror());
+	}
+
+	return result;
+}
+
+// Main thread starts first, so all threads inherit background affinity unless they have own policy
+ThreadPolicy ThreadPolicy::getDefault(const string& name)
+{
+	ThreadPolicy result(0, 1u << CPU_CORE_BACKGROUND, THREAD_STACK_SIZE_BACKGROUND);
+
+	if (name == "input_poll")
+	{
+		result = ThreadPolicy(THREAD_PRIORITY_INPUT, 1u << CPU_CORE_REALTIME, THREAD_STACK_SIZE_REALTIME);
+	}
+	else if (name == "eventqueue")
+	{
+		// Delivers input messages to CommandCenter (menu / OSD transfers to FPGA)
+		result = ThreadPolicy(THREAD_PRIORITY_EVENTS, 1u << CPU_CORE_REALTIME, THREAD_STACK_SIZE_EVENTS);
+	}
+	else if (name == "mouse_emu")
+	{
+		// Sends emulated mouse / joystick reports to FPGA each tick
+		result = ThreadPolicy(THREAD_PRIORITY_EVENTS, 1u << CPU_CORE_REALTIME, THREAD_STACK_SIZE_REALTIME);
+	}
+	else if (name == "timer_service")
+	{
+		// Key repeat / autofire timing should not depend on background load
+		result = ThreadPolicy(THREAD_PRIORITY_EVENTS, 1u << CPU_CORE_REALTIME, THREAD_STACK_SIZE_REALTIME);
+	}
+	else if (name == "input_probe")
+	{
+		// Startup device probing is mostly waiting for ioctl / sysfs replies, so use all cores while nothing else runs
+		result = ThreadPolicy(0, (1u << CPU_CORE_BACKGROUND) | (1u << CPU_CORE_REALTIME));
+	}
+
+	return result;
+}
+
+// Debug methods
+string ThreadPolicy::dump() const
+{
+	string result = tfm::format("%s, affinity: 0x%x, stack: %s",
+		isRealtime() ? tfm::format("SCHED_FIFO priority: %d", priority).c_str() : "SCHED_OTHER",
+		affinity,
+		stackSize != 0 ? tfm::format("%dKB", stackSize / 1024).c_str() : "default");
+
+	return result;
+}
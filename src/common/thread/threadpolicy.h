@@ -0,0 +1,36 @@
+#ifndef COMMON_THREAD_THREADPOLICY_H_
+#define COMMON_THREAD_THREADPOLICY_H_
+
+#include <stdint.h>
+#include <string>
+
+using namespace std;
+
+// Scheduling parameters applied to a thread when it starts
+struct ThreadPolicy
+{
+	int priority = 0;			// 0 - default policy (SCHED_OTHER / CFS), 1..99 - SCHED_FIFO with specified priority
+	uint32_t affinity = 0;		// CPU affinity bitmask (bit N = CPU N), 0 - no restrictions
+	uint32_t stackSize = 0;		// Stack size (bytes) for threads created by Runnable, 0 - system default (8MB)
+
+	ThreadPolicy() {};
+	ThreadPolicy(int priority, uint32_t affinity, uint32_t stackSize = 0) : priority(priority), affinity(affinity), stackSize(stackSize) {};
+
+	bool isRealtime() const { return priority > 0; };
+
+	// Applies policy (and thread name) to the calling thread
+	bool apply(const string& name) const;
+
+	// Lock currently mapped process pages in RAM (prevents page faults on latency-critical paths)
+	static bool lockMemory();
+
+	// Default profile: input polling and FPGA I/O dispatch get dedicated CPU with RT priority,
+	// the rest (main thread, device detection, file system scans) stays on the other CPU
+	static ThreadPolicy getDefault(const string& name);
+
+	// Debug methods
+	string dump() const;
+};
+typedef struct ThreadPolicy ThreadPolicy;
+
+#endif /* COMMON_THREAD_THREADPOLICY_H_ */
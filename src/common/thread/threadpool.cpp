@@ -0,0 +1,50 @@
+#include "threadpool.h"
+
+#include "../logger/logger.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "threadpolicy.h"
+
+void ThreadPool::parallelFor(size_t count, unsigned maxThreads, const string& name, const function<void(size_t)>& task)
+{
+	if (count == 0)
+		return;
+
+	unsigned threads = maxThreads > 0 ? maxThreads : 1;
+	threads = threads > count ? (unsigned)count : threads;
+
+	atomic<size_t> next(0);
+
+	auto worker = [&]()
+	{
+		size_t index;
+		while ((index = next.fetch_add(1)) < count)
+		{
+			task(index);
+		}
+	};
+
+	// Calling thread participates as well, so only (threads - 1) additional threads are created
+	vector<thread> workers;
+	workers.reserve(threads - 1);
+
+	for (unsigned i = 1; i < threads; i++)
+	{
+		workers.emplace_back([&]()
+		{
+			ThreadPolicy::getDefault(name).apply(name);
+			worker();
+		});
+	}
+
+	worker();
+
+	for (auto& workerThread : workers)
+	{
+		workerThread.join();
+	}
+
+	TRACE("%s: %d task(s) completed using %d thread(s)", __PRETTY_FUNCTION__, count, threads);
+}
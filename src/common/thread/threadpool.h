@@ -0,0 +1,22 @@
+#ifndef COMMON_THREAD_THREADPOOL_H_
+#define COMMON_THREAD_THREADPOOL_H_
+
+#include <stddef.h>
+#include <functional>
+#include <string>
+
+using namespace std;
+
+// Short-living worker pool for one-off batches of independent blocking tasks (device probing etc.)
+class ThreadPool
+{
+public:
+	// Executes task(0) ... task(count - 1) using up to <maxThreads> threads (calling thread is one of them)
+	// Tasks are picked in index order, method returns when all tasks are completed
+	static void parallelFor(size_t count, unsigned maxThreads, const string& name, const function<void(size_t)>& task);
+
+private:
+	ThreadPool() {};	// Static class, disallow objects creation
+};
+
+#endif /* COMMON_THREAD_THREADPOOL_H_ */
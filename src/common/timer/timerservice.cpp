@@ -0,0 +1,183 @@
+#include "timerservice.h"
+
+#include "../logger/logger.h"
+
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+TimerService& TimerService::instance()
+{
+	static TimerService instance;
+
+	return instance;
+}
+
+TimerService::~TimerService()
+{
+	dispose();
+}
+
+bool TimerService::init()
+{
+	bool result = false;
+
+	if (m_fd_timer != INVALID_FILE_DESCRIPTOR)
+		return true;
+
+	m_fd_timer = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+	if (m_fd_timer != INVALID_FILE_DESCRIPTOR)
+	{
+		// Lock parallel threads to access (active till return from method and lock destruction)
+		lock_guard<recursive_mutex> lock(m_mutexTimers);
+
+		m_wheel.setCurrent(now());
+		m_armed = TimerWheel::NO_EXPIRY;
+
+		result = true;
+	}
+	else
+	{
+		LOGERROR("%s: unable to create timer: %s", __PRETTY_FUNCTION__, logger::geterror());
+	}
+
+	return result;
+}
+
+void TimerService::dispose()
+{
+	if (m_fd_timer == INVALID_FILE_DESCRIPTOR)
+		return;
+
+	// Wake up the thread immediately, so it can notice stop request
+	m_stop = true;
+
+	itimerspec wakeup = {};
+	wakeup.it_value.tv_nsec = 1;
+	timerfd_settime(m_fd_timer, 0, &wakeup, nullptr);
+
+	stop();
+
+	close(m_fd_timer);
+	m_fd_timer = INVALID_FILE_DESCRIPTOR;
+}
+
+void TimerService::schedule(Timer& timer, uint32_t delay, uint32_t period)
+{
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<recursive_mutex> lock(m_mutexTimers);
+
+	// Idle wheel position is not updated by the thread (it sleeps till the first timer), so sync it first.
+	// Otherwise the thread keeps wheel position close to real time and expiration is counted from now
+	uint64_t current = now();
+	if (m_wheel.getCount() == 0)
+	{
+		m_wheel.setCurrent(current);
+	}
+
+	m_wheel.schedule(timer, current + (delay > 0 ? delay : 1), period);
+
+	rearm();
+}
+
+void TimerService::cancel(Timer& timer)
+{
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<recursive_mutex> lock(m_mutexTimers);
+
+	m_wheel.cancel(timer);
+
+	// Timerfd is not disarmed here - spurious wakeup is cheaper than extra syscall on each cancel
+}
+
+bool TimerService::isScheduled(Timer& timer)
+{
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<recursive_mutex> lock(m_mutexTimers);
+
+	bool result = timer.isScheduled();
+
+	return result;
+}
+
+uint64_t TimerService::now()
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	uint64_t result = (uint64_t)time.tv_sec * 1000 + time.tv_nsec / 1000000;
+
+	return result;
+}
+
+// Helper methods
+
+// Arm timerfd to the closest wheel expiration (absolute time, so no drift accumulates)
+void TimerService::rearm()
+{
+	if (m_fd_timer == INVALID_FILE_DESCRIPTOR)
+		return;
+
+	uint64_t next = m_wheel.getNextExpiry();
+	if (next == m_armed)
+		return;
+
+	itimerspec expiration = {};
+	if (next != TimerWheel::NO_EXPIRY)
+	{
+		expiration.it_value.tv_sec = next / 1000;
+		expiration.it_value.tv_nsec = (next % 1000) * 1000000;
+	}
+
+	// Zero value disarms the timer
+	if (timerfd_settime(m_fd_timer, TFD_TIMER_ABSTIME, &expiration, nullptr) == 0)
+	{
+		m_armed = next;
+	}
+	else
+	{
+		LOGERROR("%s: unable to arm timer: %s", __PRETTY_FUNCTION__, logger::geterror());
+	}
+}
+
+// Runnable override method(s)
+
+// Async thread body
+void TimerService::run()
+{
+	LOGINFO("TimerService: thread started with tid: %d (0x%x)", m_thread_id, m_thread_id);
+
+	if (m_fd_timer == INVALID_FILE_DESCRIPTOR)
+	{
+		LOGERROR("%s: timer is not initialized. Call init() first", __PRETTY_FUNCTION__);
+		return;
+	}
+
+	while (!m_stop)
+	{
+		// Blocks till the closest timer expiration
+		uint64_t expirations = 0;
+		ssize_t len = read(m_fd_timer, &expirations, sizeof(expirations));
+
+		if (m_stop)
+			break;
+
+		if (len == sizeof(expirations))
+		{
+			// Lock parallel threads to access (active till the end of the block)
+			lock_guard<recursive_mutex> lock(m_mutexTimers);
+
+			m_armed = TimerWheel::NO_EXPIRY;
+			m_wheel.advance(now());
+			rearm();
+		}
+		else if (len < 0 && errno != EINTR)
+		{
+			LOGERROR("%s: %s", __PRETTY_FUNCTION__, logger::geterror());
+			break;
+		}
+	}
+
+	LOGINFO("TimerService: thread with tid: %d (0x%x) loop stopped", m_thread_id, m_thread_id);
+}
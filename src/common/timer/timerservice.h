@@ -0,0 +1,57 @@
+#ifndef COMMON_TIMER_TIMERSERVICE_H_
+#define COMMON_TIMER_TIMERSERVICE_H_
+
+#include <stdint.h>
+#include <mutex>
+#include "../consts.h"
+#include "../thread/runnable.h"
+#include "timerwheel.h"
+
+using namespace std;
+
+// Single thread serving all software timers (key repeat, menu auto-scroll, autofire etc.)
+// Timers are kept in hierarchical wheel with 1ms tick, thread sleeps on one timerfd armed to the closest expiration.
+// Callbacks are executed on timer thread and must be short (post event / toggle state), they're allowed to schedule / cancel timers
+class TimerService : public Runnable
+{
+protected:
+	recursive_mutex m_mutexTimers;
+	TimerWheel m_wheel;
+
+	int m_fd_timer = INVALID_FILE_DESCRIPTOR;
+	uint64_t m_armed = TimerWheel::NO_EXPIRY;
+
+public:
+	// Singleton instance
+	static TimerService& instance();
+	TimerService(TimerService&&) = delete;						// Disable move constructor (C++11 feature)
+	TimerService(const TimerService& that) = delete; 			// Disable copy constructor (C++11 feature)
+	TimerService& operator =(TimerService const&) = delete;		// Disable assignment operator (C++11 feature)
+	virtual ~TimerService();
+
+public:
+	bool init();
+	void dispose();
+
+	// Intervals are in milliseconds. Scheduling already scheduled timer re-schedules it
+	void schedule(Timer& timer, uint32_t delay, uint32_t period = 0);
+	void cancel(Timer& timer);
+	bool isScheduled(Timer& timer);
+
+	// Time helper (milliseconds, CLOCK_MONOTONIC)
+	static uint64_t now();
+
+// Helper methods
+protected:
+	void rearm();
+
+// Runnable override method(s)
+protected:
+	// Async thread body
+	void run();
+
+private:
+	TimerService() : Runnable("timer_service") {};	// Disable explicit object creation (only singleton instance allowed)
+};
+
+#endif /* COMMON_TIMER_TIMERSERVICE_H_ */
@@ -0,0 +1,214 @@
+#include "timerwheel.h"
+
+#include "../logger/logger.h"
+
+// Out-of-class definitions for constants (required for C++14 if constant is odr-used)
+constexpr unsigned TimerWheel::LEVELS;
+constexpr unsigned TimerWheel::SLOT_BITS;
+constexpr unsigned TimerWheel::SLOTS;
+constexpr uint64_t TimerWheel::NO_EXPIRY;
+
+TimerWheel::TimerWheel()
+{
+	for (unsigned level = 0; level < LEVELS; level++)
+	{
+		for (unsigned slot = 0; slot < SLOTS; slot++)
+		{
+			TimerNode& head = m_slots[level][slot];
+			head.prev = &head;
+			head.next = &head;
+		}
+	}
+}
+
+// Schedule (or re-schedule if already scheduled) timer to fire at <expires> tick
+void TimerWheel::schedule(Timer& timer, uint64_t expires, uint32_t period)
+{
+	if (timer.isScheduled())
+	{
+		cancel(timer);
+	}
+
+	// Timer can't fire in the past (or in the slot being processed right now)
+	timer.expires = expires > m_current ? expires : m_current + 1;
+	timer.period = period;
+
+	link(timer);
+	m_count++;
+}
+
+void TimerWheel::cancel(Timer& timer)
+{
+	if (timer.isScheduled())
+	{
+		unlink(timer);
+		m_count--;
+	}
+}
+
+// Move wheel position to <now>, firing all expired timers
+// Returns number of timers fired
+unsigned TimerWheel::advance(uint64_t now)
+{
+	unsigned result = 0;
+
+	// Nothing to process - just jump
+	if (m_count == 0)
+	{
+		m_current = now > m_current ? now : m_current;
+		return result;
+	}
+
+	while (m_current < now)
+	{
+		m_current++;
+
+		// Slot 0 on any level means we've entered new slot on the next level - pull its timers down
+		uint64_t position = m_current;
+		for (unsigned level = 1; level < LEVELS && (position & (SLOTS - 1)) == 0; level++)
+		{
+			position >>= SLOT_BITS;
+			cascade(level);
+		}
+
+		// Fire everything in the current slot. Callback can schedule / cancel any timer (including already fired),
+		// so list head is re-checked on each iteration
+		TimerNode& head = m_slots[0][m_current & (SLOTS - 1)];
+		while (!isEmpty(head))
+		{
+			Timer& timer = *static_cast<Timer*>(head.next);
+			unlink(timer);
+			m_count--;
+
+			if (timer.period > 0)
+			{
+				timer.expires += timer.period;
+				timer.expires = timer.expires > m_current ? timer.expires : m_current + 1;
+
+				link(timer);
+				m_count++;
+			}
+
+			result++;
+
+			if (timer.callback)
+			{
+				timer.callback();
+			}
+		}
+
+		if (m_count == 0)
+		{
+			m_current = now;
+		}
+	}
+
+	return result;
+}
+
+// Returns closest tick when wheel needs to be advanced: either earliest expiration from level 0
+// or the moment when timers from coarser levels need to be cascaded
+// NO_EXPIRY is returned if there are no timers scheduled
+uint64_t TimerWheel::getNextExpiry()
+{
+	uint64_t result = NO_EXPIRY;
+
+	if (m_count == 0)
+		return result;
+
+	for (unsigned level = 0; level < LEVELS; level++)
+	{
+		unsigned shift = level * SLOT_BITS;
+		uint64_t position = m_current >> shift;
+
+		for (unsigned offset = 1; offset <= SLOTS; offset++)
+		{
+			if (!isEmpty(m_slots[level][(position + offset) & (SLOTS - 1)]))
+			{
+				uint64_t tick = (position + offset) << shift;
+				result = tick < result ? tick : result;
+				break;
+			}
+		}
+	}
+
+	return result;
+}
+
+uint64_t TimerWheel::getCurrent()
+{
+	return m_current;
+}
+
+// Set wheel position (allowed only while no timers are scheduled)
+void TimerWheel::setCurrent(uint64_t now)
+{
+	if (m_count == 0)
+	{
+		m_current = now;
+	}
+	else
+	{
+		LOGWARN("%s: unable to change wheel position while %d timer(s) scheduled", __PRETTY_FUNCTION__, m_count);
+	}
+}
+
+unsigned TimerWheel::getCount()
+{
+	return m_count;
+}
+
+// Helper methods
+
+// Select level by distance to expiration and insert timer into the slot covering expiration tick
+void TimerWheel::link(Timer& timer)
+{
+	uint64_t delta = timer.expires - m_current;
+
+	unsigned level = 0;
+	while (level < LEVELS - 1 && delta >= ((uint64_t)1 << ((level + 1) * SLOT_BITS)))
+	{
+		level++;
+	}
+
+	// Timers beyond the wheel range are parked in the farthest top level slot and re-linked on cascade
+	uint64_t expires = timer.expires;
+	uint64_t range = (uint64_t)1 << (LEVELS * SLOT_BITS);
+	if (delta >= range)
+	{
+		expires = m_current + range - 1;
+	}
+
+	TimerNode& head = m_slots[level][(expires >> (level * SLOT_BITS)) & (SLOTS - 1)];
+
+	timer.prev = head.prev;
+	timer.next = &head;
+	head.prev->next = &timer;
+	head.prev = &timer;
+}
+
+void TimerWheel::unlink(TimerNode& node)
+{
+	node.prev->next = node.next;
+	node.next->prev = node.prev;
+	node.prev = nullptr;
+	node.next = nullptr;
+}
+
+// Re-distribute timers from current slot of <level> to finer levels
+void TimerWheel::cascade(unsigned level)
+{
+	TimerNode& head = m_slots[level][(m_current >> (level * SLOT_BITS)) & (SLOTS - 1)];
+
+	while (!isEmpty(head))
+	{
+		Timer& timer = *static_cast<Timer*>(head.next);
+		unlink(timer);
+		link(timer);
+	}
+}
+
+bool TimerWheel::isEmpty(const TimerNode& head)
+{
+	return head.next == &head;
+}
@@ -0,0 +1,76 @@
+#ifndef COMMON_TIMER_TIMERWHEEL_H_
+#define COMMON_TIMER_TIMERWHEEL_H_
+
+#include <stdint.h>
+#include <functional>
+
+using namespace std;
+
+typedef function<void()> TimerCallback;
+
+// Intrusive list node, so timers can be linked / unlinked in O(1) without allocations
+struct TimerNode
+{
+	TimerNode* prev = nullptr;
+	TimerNode* next = nullptr;
+};
+typedef struct TimerNode TimerNode;
+
+// Timer instance is owned by the client (usually a class member) and linked into the wheel while scheduled
+// Timer must be cancelled before destruction
+struct Timer : public TimerNode
+{
+	uint64_t expires = 0;		// Absolute expiration time (in wheel ticks)
+	uint32_t period = 0;		// Re-schedule interval for periodic timers (0 - one-shot)
+	TimerCallback callback;
+
+	Timer() {};
+	Timer(const TimerCallback& callback) : callback(callback) {};
+
+	Timer(const Timer& that) = delete; 				// Disable copy constructor (C++11 feature)
+	Timer& operator =(Timer const&) = delete;		// Disable assignment operator (C++11 feature)
+
+	bool isScheduled() const { return next != nullptr; };
+};
+typedef struct Timer Timer;
+
+// Hierarchical timer wheel (4 levels x 64 slots).
+// Level 0 slots have single tick resolution, each next level - 64 times coarser.
+// Timers from coarse levels are cascaded to the finer ones when wheel position reaches their slot.
+// Schedule / cancel are O(1), advance is O(1) amortized per tick. Class is not thread-safe (see TimerService)
+class TimerWheel
+{
+public:
+	static constexpr unsigned LEVELS = 4;
+	static constexpr unsigned SLOT_BITS = 6;
+	static constexpr unsigned SLOTS = 1 << SLOT_BITS;
+	static constexpr uint64_t NO_EXPIRY = UINT64_MAX;
+
+protected:
+	TimerNode m_slots[LEVELS][SLOTS];	// Circular list heads
+	uint64_t m_current = 0;				// Current wheel position (all timers expiring at or before it are fired)
+	unsigned m_count = 0;
+
+public:
+	TimerWheel();
+
+	void schedule(Timer& timer, uint64_t expires, uint32_t period = 0);
+	void cancel(Timer& timer);
+
+	unsigned advance(uint64_t now);
+	uint64_t getNextExpiry();
+
+	uint64_t getCurrent();
+	void setCurrent(uint64_t now);
+	unsigned getCount();
+
+// Helper methods
+protected:
+	void link(Timer& timer);
+	static void unlink(TimerNode& node);
+	void cascade(unsigned level);
+
+	static bool isEmpty(const TimerNode& head);
+};
+
+#endif /* COMMON_TIMER_TIMERWHEEL_H_ */
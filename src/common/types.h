@@ -68,5 +68,28 @@ BETTER_ENUM(InputDeviceTypeEnum, uint8_t,
 	Joystick
 )
 
+// Input processing pipeline stages (used for latency tracing, each stage measured from kernel event timestamp)
+BETTER_ENUM(LatencyStageEnum, uint8_t,
+	Wakeup = 0,		// epoll_wait returned with event(s)
+	Post,			// Message posted to MessageCenter queue
+	Dispatch,		// Message delivered to the observer
+	Mapper,			// Events resolved into core / menu representation
+	Transfer		// Data transfer to FPGA completed
+)
+
+// Joystick autofire rates (same order as in OSD menu)
+BETTER_ENUM(AutofireRateEnum, uint8_t,
+	Off = 0,
+	Fast,
+	Medium,
+	Slow
+)
+
+// Image formats for headless OSD rendering
+BETTER_ENUM(OSDImageFormatEnum, uint8_t,
+	PGM = 0,		// Binary greymap (P5), viewable by most image tools
+	ASCII			// Text dump ('#' - pixel set, '.' - clear), suitable for diffs
+)
+
 
 #endif /* COMMON_TYPES_H_ */
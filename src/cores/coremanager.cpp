@@ -30,6 +30,7 @@ bool CoreManager::loadCore(const string& filename)
 		// Determine core type
 		FPGACommand& command = *device.command;
 		CoreType coreType = command.getCoreType();
+		command.negotiateIOMode();
 		LOGINFO("Core name: %s", command.getCoreName().c_str());
 		LOGINFO("Core config: %s", command.getCoreConfig().c_str());
 		LOGINFO("%s", command.getVideoMode().c_str());
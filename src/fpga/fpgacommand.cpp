@@ -34,7 +34,7 @@ CoreType FPGACommand::getCoreType()
 	CoreType result = CoreType::CORE_TYPE_UNKNOWN;
 
 	// Each command should have this check as a first call
-	if (!checkExecution())
+	if (!checkExecution(true))
 		return result;
 
 	// Reset gpo[31] - that triggers returning magic number (0x5CA623) from FPGA side in gpi[31:8] and core ID in gpi[7:0]
@@ -66,8 +66,8 @@ string FPGACommand::getCoreName()
 {
 	static char result[128 + 1];
 
-	// If parallel FPGA data transfer transaction executed - just exit
-	if (!startIO())
+	// Parallel FPGA data transfer (e.g. OSD frame) is finished first
+	if (!startIO(true))
 		return nullptr;
 
 	// Request Identification / Config string from the FPGA core
@@ -109,8 +109,8 @@ string FPGACommand::getCoreConfig()
 {
 	static char result[128 + 1];
 
-	// If parallel FPGA data transfer transaction executed - just exit
-	if (!startIO())
+	// Parallel FPGA data transfer (e.g. OSD frame) is finished first
+	if (!startIO(true))
 		return nullptr;
 
 	// Request Identification / Config string from the FPGA core
@@ -154,7 +154,7 @@ string FPGACommand::getVideoMode()
 {
 	string result;
 
-	if (startIO())
+	if (startIO(true))
 	{
 		sendCommand(UIO_GET_VRES);
 
@@ -182,6 +182,125 @@ string FPGACommand::getVideoMode()
 	return result;
 }
 
+// IO interface capabilities
+
+/*
+ * Data bus width supported by the core IO module: gpi[16] (FIO_SIZE_8BIT / FIO_SIZE_16BIT)
+ */
+uint8_t FPGACommand::getFPGAIOSize()
+{
+	uint8_t result = FIO_SIZE_8BIT;
+
+	if (!checkExecution(true))
+		return result;
+
+	uint32_t gpi = fpga->gpi_read();
+	if ((int32_t)gpi >= 0)
+	{
+		result = (gpi >> 16) & 0x01;
+	}
+	else
+	{
+		LOGERROR("GPI[31]==1. FPGA is uninitialized?\n");
+	}
+
+	endExecution();
+
+	return result;
+}
+
+/*
+ * Core IO module protocol version: gpi[19:18]
+ */
+uint8_t FPGACommand::getFPGAIOVersion()
+{
+	uint8_t result = 0;
+
+	if (!checkExecution(true))
+		return result;
+
+	uint32_t gpi = fpga->gpi_read();
+	if ((int32_t)gpi >= 0)
+	{
+		result = (gpi >> 18) & 0x03;
+	}
+	else
+	{
+		LOGERROR("GPI[31]==1. FPGA is uninitialized?\n");
+	}
+
+	endExecution();
+
+	return result;
+}
+
+/*
+ * Select bulk transfer width for the currently loaded core. Should be called each time new core is loaded
+ * Returns true if wide (16-bit) transfers are enabled
+ */
+bool FPGACommand::negotiateIOMode()
+{
+	uint8_t ioSize = getFPGAIOSize();
+	uint8_t ioVersion = getFPGAIOVersion();
+
+	wideIO = ioSize == FIO_SIZE_16BIT;
+
+	LOGINFO("FPGA IO: size: %d, version: %d. Bulk transfers: %s", ioSize, ioVersion, wideIO ? "16-bit" : "8-bit");
+
+	return wideIO;
+}
+
+bool FPGACommand::isWideIO()
+{
+	return wideIO;
+}
+
+// Core status commands
+
+/*
+ * Update lower 8 status bits selected by <mask> (UIO_SET_STATUS)
+ */
+void FPGACommand::setStatus(uint8_t value, uint8_t mask)
+{
+	status = (status & ~(uint32_t)mask) | (value & mask);
+
+	if (startIO(true))
+	{
+		sendCommand(UIO_SET_STATUS, (uint8_t)status);
+
+		endIO();
+	}
+}
+
+/*
+ * Update status bits selected by <mask> (UIO_SET_STATUS2). Value is sent LSB first:
+ * as two 16-bit words in wide mode or four bytes otherwise
+ */
+void FPGACommand::setStatus32(uint32_t value, uint32_t mask)
+{
+	status = (status & ~mask) | (value & mask);
+
+	if (startIO(true))
+	{
+		send8(UIO_SET_STATUS2);
+
+		if (wideIO)
+		{
+			connector->transferWord((uint16_t)status);
+			connector->transferWord((uint16_t)(status >> 16));
+		}
+		else
+		{
+			send8(status);
+			send8(status >> 8);
+			send8(status >> 16);
+			send8(status >> 24);
+		}
+
+		endIO();
+	}
+}
+
 // OSD commands
 
 /*
@@ -201,6 +320,15 @@ bool FPGACommand::startOSD()
 	return result;
 }
 
+/*
+ * Finishes current command and starts the next one within the same OSD transaction (FPGA stays locked)
+ */
+void FPGACommand::nextOSD()
+{
+	connector->disableOSD();
+	connector->enableOSD();
+}
+
 /*
  * Ends OSD transaction and unblocks communication with FPGA
  */
@@ -264,11 +392,11 @@ void FPGACommand::sendOSDCommand(uint8_t cmd, uint32_t param)
 /*
  * Starts IO transaction. No other commands (any type) can be executed to interact with FPGA until transaction finished.
  */
-bool FPGACommand::startIO()
+bool FPGACommand::startIO(bool isWaiting)
 {
 	bool result = false;
 
-	if (checkExecution())
+	if (checkExecution(isWaiting))
 	{
 		connector->enableIO();
 
@@ -278,6 +406,16 @@ bool FPGACommand::startIO()
 	return result;
 }
 
+/*
+ * Finishes current command and starts the next one within the same IO transaction.
+ * Each UIO command has to be framed by IO enable strobe, but FPGA stays locked for the whole batch
+ */
+void FPGACommand::nextIO()
+{
+	connector->disableIO();
+	connector->enableIO();
+}
+
 /*
  * Ends IO transaction and unblocks communication with FPGA
  */
@@ -362,6 +500,21 @@ void FPGACommand::sendCommand(uint8_t cmd, uint32_t param)
 	send32(param);
 }
 
+void FPGACommand::sendCommand(uint8_t cmd, const uint8_t* data, uint16_t length)
+{
+	send8(cmd);
+	connector->write((uint8_t*)data, length, false);
+}
+
+/*
+ * Bulk payload transfer (OSD framebuffer etc.) within already started transaction.
+ * Uses two bytes per handshake if wide mode was negotiated with the core
+ */
+void FPGACommand::sendData(const uint8_t* data, uint16_t length)
+{
+	connector->write((uint8_t*)data, length, wideIO);
+}
+
 // Read commands
 uint8_t FPGACommand::readByte()
 {
@@ -5,6 +5,7 @@
 
 #include <string>
 #include <stdint.h>
+#include <string.h>
 #include <pthread.h>
 
 #include "fpgadevice.h"
@@ -39,6 +40,12 @@ protected:
 	// Ensure that command scope untouched during the whole execution with mutex guard
 	pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 
+	// Negotiated with the core after load: true - 16 bits are transferred per strobe/ACK handshake
+	bool wideIO = false;
+
+	// Last status value sent to the core (UIO_SET_STATUS / UIO_SET_STATUS2)
+	uint32_t status = 0;
+
 public:
 	FPGACommand(FPGAConnector *connector);
 	FPGACommand(const FPGACommand& that) = delete; // Copy constructor is forbidden here (C++11 feature)
@@ -50,8 +57,19 @@ public:
 	string getCoreConfig();
 	string getVideoMode();
 
+	// IO interface capabilities
+	uint8_t getFPGAIOSize();
+	uint8_t getFPGAIOVersion();
+	bool negotiateIOMode();
+	bool isWideIO();
+
+	// Core status commands
+	void setStatus(uint8_t value, uint8_t mask = 0xFF);
+	void setStatus32(uint32_t value, uint32_t mask = 0xFFFFFFFF);
+
 	// OSD commands
 	bool startOSD();
+	void nextOSD();
 	void endOSD();
 	void sendOSDCommand(uint8_t cmd);
 	void sendOSDCommand(uint8_t cmd, uint8_t param);
@@ -59,7 +77,8 @@ public:
 	void sendOSDCommand(uint8_t cmd, uint32_t param);
 
 	// IO commands
-	bool startIO();
+	bool startIO(bool isWaiting = false);
+	void nextIO();
 	void endIO();
 	void sendIOCommand(uint8_t cmd);
 	void sendIOCommand(uint8_t cmd, uint8_t param);
@@ -71,6 +90,8 @@ public:
 	void sendCommand(uint8_t cmd, uint8_t param);
 	void sendCommand(uint8_t cmd, uint16_t param);
 	void sendCommand(uint8_t cmd, uint32_t param);
+	void sendCommand(uint8_t cmd, const uint8_t* data, uint16_t length);
+	void sendData(const uint8_t* data, uint16_t length);
 
 	// Read commands
 	uint8_t readByte();
@@ -78,7 +99,9 @@ public:
 
 protected:
 	// Helper methods
-	__inline bool checkExecution() __attribute__((always_inline))
+	// <isWaiting> - wait for the command in progress (non-realtime callers, e.g. core probing / configuration).
+	// Realtime callers never wait: OSD transfer in progress can take several milliseconds
+	__inline bool checkExecution(bool isWaiting = false) __attribute__((always_inline))
 	{
 		bool result = true;
 
@@ -90,9 +113,20 @@ protected:
 		}
 		else
 		{
-			if (pthread_mutex_trylock(&mutex) != 0)
+			// Busy FPGA is a routine case for realtime callers (they retry or skip), so only failed wait is an error
+			if (isWaiting)
 			{
-				LOGERROR("Unable to execute FPGA command when other command is still in progress\n");
+				int status = pthread_mutex_lock(&mutex);
+				if (status != 0)
+				{
+					LOGERROR("Unable to wait for FPGA command in progress: %s\n", strerror(status));
+
+					result = false;
+				}
+			}
+			else if (pthread_mutex_trylock(&mutex) != 0)
+			{
+				TRACE("FPGA command skipped, other command is still in progress");
 
 				result = false;
 			}
@@ -259,6 +293,10 @@ protected:
 // user io status bits (currently only used by 8bit)
 #define UIO_STATUS_RESET   0x01
 
+// FPGA IO interface capabilities (reported via gpi while no transfer is in progress)
+#define FIO_SIZE_8BIT      0         // 8 bits per strobe/ACK handshake
+#define FIO_SIZE_16BIT     1         // 16 bits per strobe/ACK handshake
+
 #define UIO_STOP_BIT_1   0
 #define UIO_STOP_BIT_1_5 1
 #define UIO_STOP_BIT_2   2
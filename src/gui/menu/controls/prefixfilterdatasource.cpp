@@ -0,0 +1,58 @@
+#include "prefixfilterdatasource.h"
+
+#include <algorithm>
+
+// Index range is ordered by folded key, so positions are mapped to source indexes and sorted back into source order
+void PrefixFilterDataSource::setRange(IListDataSource* source, const PrefixIndex* index, int first, int last)
+{
+	m_source = source;
+	m_items.clear();
+
+	if (index == nullptr || last <= first)
+		return;
+
+	m_items.reserve(last - first);
+	for (int position = first; position < last; position++)
+	{
+		int item = index->getItemIndex(position);
+		if (item >= 0)
+		{
+			m_items.push_back(item);
+		}
+	}
+
+	sort(m_items.begin(), m_items.end());
+}
+
+// Map filtered position into the underlying data source index
+int PrefixFilterDataSource::getSourceIndex(int index)
+{
+	int result = -1;
+
+	if (index >= 0 && index < (int)m_items.size())
+	{
+		result = m_items[index];
+	}
+
+	return result;
+}
+
+// IListDataSource implementation
+
+int PrefixFilterDataSource::getItemCount()
+{
+	return m_items.size();
+}
+
+bool PrefixFilterDataSource::getItem(int index, ListItem& item)
+{
+	bool result = false;
+
+	int sourceIndex = getSourceIndex(index);
+	if (m_source != nullptr && sourceIndex >= 0)
+	{
+		result = m_source->getItem(sourceIndex, item);
+	}
+
+	return result;
+}
@@ -0,0 +1,30 @@
+#ifndef GUI_MENU_CONTROLS_PREFIXFILTERDATASOURCE_H_
+#define GUI_MENU_CONTROLS_PREFIXFILTERDATASOURCE_H_
+
+#include <stdint.h>
+#include <vector>
+#include "../../../common/helpers/prefixindex.h"
+#include "../../../interfaces/ilistdatasource.h"
+
+// View over data source showing only items from PrefixIndex range (type-ahead narrowing). No items are copied.
+// Matches keep the data source order (e.g. natural "Game 2" before "Game 10"), not the index key order
+class PrefixFilterDataSource : public IListDataSource
+{
+protected:
+	IListDataSource* m_source = nullptr;
+	vector<uint32_t> m_items;		// Source indexes of matched items (ascending)
+
+public:
+	PrefixFilterDataSource() {};
+	virtual ~PrefixFilterDataSource() {};
+
+	void setRange(IListDataSource* source, const PrefixIndex* index, int first, int last);
+	int getSourceIndex(int index);
+
+// IListDataSource implementation
+public:
+	int getItemCount();
+	bool getItem(int index, ListItem& item);
+};
+
+#endif /* GUI_MENU_CONTROLS_PREFIXFILTERDATASOURCE_H_ */
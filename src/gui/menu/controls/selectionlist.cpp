@@ -3,73 +3,145 @@
 #include "../../../common/logger/logger.h"
 
 #include <math.h>
+#include "../../../common/consts.h"
+#include "../../../common/timer/timerservice.h"
 #include "../../osd/osd.h"
 
-void SelectionList::setDataSource(const ListItemVector& data)
+void SelectionList::setDataSource(IListDataSource* dataSource)
 {
-	// Make local copy of list
-	m_data = data;
+	// New data - type-ahead index (if any) belongs to the previous one
+	m_unfilteredSource = dataSource;
+	m_prefixIndex = nullptr;
+	m_typeAhead.clear();
 
-	int len = m_data.size();
+	applyDataSource(dataSource, 0);
+}
 
-	// Calculate scroll bar parameters
-	if (len > m_height)
-	{
-		m_showScrollBar = true;
+// Items were appended to the data source (e.g. next batch from folder scan) - keep selection and visible position
+void SelectionList::reload()
+{
+	// Type-ahead view is bound to the index built over previous items
+	if (!m_typeAhead.empty())
+		return;
 
-		// Calculate scroll bar height
-		// Step 1: Calculate ratio between control height and number of records to display
-		// Step 2: Set scroll bar progress height as height * ratio
-		// Example:
-		//     Control height: 10 lines
-		//     Data records:   15
-		//     ratio: 10 / 15 = 0.66
-		//     scroll bar progress height: 10 * 0.66 = 7 lines
-		double ratio = (double)m_height / (double)len;
-		m_scrollBarHeight = (int)(ceil((double)m_height * ratio));
+	applyDataSource(m_unfilteredSource, m_selectedIndex, m_topIndex);
+}
 
-		// Set scroll progress on top position (coordinates relative to SelectionList)
-		m_scrollBarTop = 0;
-	}
-	else
-	{
-		m_showScrollBar = false;
-		m_scrollBarTop = -1;
-		m_scrollBarHeight = 0;
-	}
+// Index has to be built over the current data source items (same indexes)
+void SelectionList::setPrefixIndex(const PrefixIndex* index)
+{
+	m_prefixIndex = index;
+}
+
+int SelectionList::getSelectedIndex()
+{
+	return m_selectedIndex;
+}
+
+void SelectionList::setSelectedIndex(int index)
+{
+	if (index < 0 || index >= m_count || index == m_selectedIndex)
+		return;
+
+	removeSelectedHighlight();
+
+	m_selectedIndex = index;
+	recalcPosition();
+	drawContent();
+}
+
+// Selected item index in the data source passed to setDataSource (type-ahead filter is taken into account)
+int SelectionList::getSelectedSourceIndex()
+{
+	int result = m_selectedIndex;
 
-	// Select first record if available
-	if (m_data.size() > 0)
+	if (!m_typeAhead.empty())
 	{
-		m_selectedIndex = 0;
-		m_topIndex = 0;
+		result = m_filter.getSourceIndex(m_selectedIndex);
 	}
-	else
+
+	return result;
+}
+
+const ListItem* SelectionList::getSelectedItem()
+{
+	const ListItem* result = nullptr;
+
+	if (m_selectedIndex >= 0 && m_selectedIndex < m_count)
 	{
-		m_selectedIndex = -1;
-		m_topIndex = -1;
+		result = fetchItem(m_selectedIndex);
 	}
 
-	drawContent();
+	return result;
 }
 
-int SelectionList::getSelectedIndex()
+const string& SelectionList::getTypeAhead()
 {
-	return m_selectedIndex;
+	return m_typeAhead;
 }
 
-const ListItem* SelectionList::getSelectedItem()
+/*
+ * Type-ahead: each typed symbol extends the prefix and the list is narrowed to items starting with it
+ * (first match is selected). Typing after TYPEAHEAD_TIMEOUT pause starts a new prefix.
+ * Symbol is ignored (returns false) if nothing matches the extended prefix
+ */
+bool SelectionList::typeAhead(char symbol)
+{
+	bool result = false;
+
+	if (m_prefixIndex == nullptr || !m_prefixIndex->isBuilt())
+		return result;
+
+	uint64_t now = TimerService::now();
+	string prefix = now - m_lastTypeAhead > TYPEAHEAD_TIMEOUT ? "" : m_typeAhead;
+	prefix.push_back(symbol);
+	m_lastTypeAhead = now;
+
+	result = applyTypeAhead(prefix);
+
+	return result;
+}
+
+// Remove last symbol from type-ahead prefix (full list is restored once prefix is empty)
+bool SelectionList::eraseTypeAhead()
 {
-	ListItem* result = nullptr;
+	bool result = false;
+
+	if (m_typeAhead.empty())
+		return result;
+
+	string prefix = m_typeAhead.substr(0, m_typeAhead.size() - 1);
+	m_lastTypeAhead = TimerService::now();
 
-	if (m_selectedIndex > 0 && m_selectedIndex < (int)m_data.size())
+	if (prefix.empty())
+	{
+		result = resetTypeAhead();
+	}
+	else
 	{
-		result = &m_data[m_selectedIndex];
+		result = applyTypeAhead(prefix);
 	}
 
 	return result;
 }
 
+// Show full list again, keeping selected item
+bool SelectionList::resetTypeAhead()
+{
+	bool result = false;
+
+	if (m_typeAhead.empty())
+		return result;
+
+	int selected = getSelectedSourceIndex();
+	m_typeAhead.clear();
+
+	applyDataSource(m_unfilteredSource, selected >= 0 ? selected : 0);
+	result = true;
+
+	return result;
+}
+
 // Control methods
 void SelectionList::pageUp()
 {
@@ -115,7 +187,7 @@ void SelectionList::pageDown()
 	bool redrawRequired = false;
 	int newSelectedIndex = -1;
 	int adjustedHeight = m_height - 1;
-	int size = m_data.size() > 0 ? m_data.size() - 1 : 0;
+	int size = m_count > 0 ? m_count - 1 : 0;
 
 	if (m_selectedIndex + adjustedHeight <= size)
 	{
@@ -124,7 +196,7 @@ void SelectionList::pageDown()
 	}
 	else if (m_selectedIndex != size)
 	{
-		newSelectedIndex = m_data.size() - 1;
+		newSelectedIndex = m_count - 1;
 		redrawRequired = true;
 	}
 
@@ -156,8 +228,7 @@ void SelectionList::moveUp()
 void SelectionList::moveDown()
 {
 	if (m_selectedIndex >= 0 &&
-		m_selectedIndex < m_height &&
-		m_selectedIndex < (int)m_data.size())
+		m_selectedIndex < m_count - 1)
 	{
 		removeSelectedHighlight();
 
@@ -171,11 +242,10 @@ void SelectionList::moveDown()
 
 void SelectionList::enter()
 {
-	if (m_selectedIndex >= 0)
+	const ListItem* item = getSelectedItem();
+	if (item != nullptr)
 	{
-		ListItem& item = m_data[m_selectedIndex];
-
-		DEBUG("Item '%s' with value: %d selected", item.name.c_str(), item.value);
+		DEBUG("Item '%s' with value: %d selected", item->name.c_str(), item->value);
 	}
 }
 
@@ -184,11 +254,78 @@ void SelectionList::cancel()
 	DEBUG("Cancel/back pressed");
 }
 
+// Periodic UI tick: scroll highlighted item name if it doesn't fit (only that line is updated)
+void SelectionList::tick()
+{
+	OSD& osd = OSD::instance();
+
+	if (osd.scrollTextStep())
+	{
+		osd.compose();
+	}
+}
+
 // Helper methods
+// Switch displayed data (full or type-ahead filtered) and select <selectedIndex> item
+void SelectionList::applyDataSource(IListDataSource* dataSource, int selectedIndex, int topIndex)
+{
+	removeSelectedHighlight();
+
+	// Items are fetched on demand, only visible window is kept
+	m_dataSource = dataSource;
+	m_count = dataSource != nullptr ? dataSource->getItemCount() : 0;
+	m_cache.clear();
+	m_cacheStart = 0;
+	m_selectedOnScreenPos = -1;
+
+	int len = m_count;
+
+	// Calculate scroll bar parameters
+	if (len > m_height)
+	{
+		m_showScrollBar = true;
+
+		// Calculate scroll bar height
+		// Step 1: Calculate ratio between control height and number of records to display
+		// Step 2: Set scroll bar progress height as height * ratio
+		// Example:
+		//     Control height: 10 lines
+		//     Data records:   15
+		//     ratio: 10 / 15 = 0.66
+		//     scroll bar progress height: 10 * 0.66 = 7 lines
+		double ratio = (double)m_height / (double)len;
+		m_scrollBarHeight = (int)(ceil((double)m_height * ratio));
+
+		// Set scroll progress on top position (coordinates relative to SelectionList)
+		m_scrollBarTop = 0;
+	}
+	else
+	{
+		m_showScrollBar = false;
+		m_scrollBarTop = -1;
+		m_scrollBarHeight = 0;
+	}
+
+	// Select requested record (or the first one) if available
+	if (m_count > 0)
+	{
+		m_selectedIndex = selectedIndex >= 0 && selectedIndex < m_count ? selectedIndex : 0;
+		m_topIndex = topIndex >= 0 && topIndex < m_count ? topIndex : 0;
+		recalcPosition();
+	}
+	else
+	{
+		m_selectedIndex = -1;
+		m_topIndex = -1;
+	}
+
+	drawContent();
+}
+
 void SelectionList::drawContent()
 {
 	// Check if we can draw something
-	if (m_data.size() == 0 || m_topIndex < 0)
+	if (m_count == 0 || m_topIndex < 0)
 	{
 		return;
 	}
@@ -201,10 +338,17 @@ void SelectionList::drawContent()
 
 	OSD& osd = OSD::instance();
 
-	uint8_t rowOffset = m_topIndex >= 0 ? m_topIndex : 0;
-	for (uint8_t row = 0; row < m_height && row < m_data.size(); row++)
+	// Content will be redrawn from scratch (scrolling restarts for newly highlighted item)
+	osd.stopTextScroll();
+
+	int rowOffset = m_topIndex >= 0 ? m_topIndex : 0;
+	for (int row = 0; row < m_height && rowOffset + row < m_count; row++)
 	{
-		auto& item = m_data[rowOffset + row];
+		const ListItem* itemPtr = fetchItem(rowOffset + row);
+		if (itemPtr == nullptr)
+			break;
+
+		const ListItem& item = *itemPtr;
 		bool isItemHighlighted =  m_selectedIndex == rowOffset + row;
 		int length = item.name.size();
 		uint8_t currentRow = m_top + row;
@@ -222,7 +366,7 @@ void SelectionList::drawContent()
 			uint8_t top = currentRow * 8;
 			uint8_t width = allowedWidth * 8 - left;
 			uint8_t height = 8;
-			osd.fillRectOptimized(left, top, width, height, true);
+			osd.fillRect(left, top, width, height, true);
 		}
 
 		if (isItemHighlighted)
@@ -236,9 +380,21 @@ void SelectionList::drawContent()
 			uint8_t height = 8;
 
 			osd.invertRect(left, top, width, height);
+
+			// Long name - let it scroll within the text area of the row
+			osd.startTextScroll(currentRow, left, (allowedWidth - m_left) * 8, item.name, true);
 		}
 	}
 
+	// List can be shorter than control (e.g. narrowed by type-ahead) - clear remaining rows
+	for (int row = m_count - rowOffset; row < m_height; row++)
+	{
+		if (row < 0)
+			continue;
+
+		osd.fillRect(m_left * 8, (m_top + row) * 8, allowedWidth * 8 - m_left * 8, 8, true);
+	}
+
 	// Debug - should be called when all controls alread drawn from main GUI module
 	osd.compose();
 }
@@ -284,7 +440,7 @@ void SelectionList::removeSelectedHighlight()
 		uint8_t width = allowedWidth * 8;
 		uint8_t height = 8;
 
-		osd.invertRectOptimized(left, top, width, height);
+		osd.invertRect(left, top, width, height);
 	}
 }
 
@@ -309,3 +465,69 @@ void SelectionList::recalcPosition()
 
 	TRACE("selectedIndex: %d, topIndex: %d", m_selectedIndex, m_topIndex);
 }
+
+// Get item from materialized window. If <index> is outside - window is moved around the viewport
+// (items already fetched are reused). Returned pointer is valid till the next fetch
+const ListItem* SelectionList::fetchItem(int index)
+{
+	const ListItem* result = nullptr;
+
+	if (m_dataSource == nullptr || index < 0 || index >= m_count)
+		return result;
+
+	int cacheEnd = m_cacheStart + (int)m_cache.size();
+	if (index < m_cacheStart || index >= cacheEnd)
+	{
+		int top = m_topIndex >= 0 ? m_topIndex : 0;
+		int start = (index < top ? index : top) - PREFETCH_ROWS;
+		int end = (index + 1 > top + m_height ? index + 1 : top + m_height) + PREFETCH_ROWS;
+		start = start < 0 ? 0 : start;
+		end = end > m_count ? m_count : end;
+
+		ListItemVector window(end - start);
+		for (int idx = start; idx < end; idx++)
+		{
+			ListItem& item = window[idx - start];
+
+			if (idx >= m_cacheStart && idx < cacheEnd)
+			{
+				item = move(m_cache[idx - m_cacheStart]);
+			}
+			else if (!m_dataSource->getItem(idx, item))
+			{
+				LOGWARN("%s: unable to fetch item %d from data source", __PRETTY_FUNCTION__, idx);
+			}
+		}
+
+		m_cache.swap(window);
+		m_cacheStart = start;
+	}
+
+	result = &m_cache[index - m_cacheStart];
+
+	return result;
+}
+
+// Narrow the list to items matching <prefix>. Prefix is kept unchanged if nothing matches
+bool SelectionList::applyTypeAhead(const string& prefix)
+{
+	bool result = false;
+
+	int first = 0;
+	int last = 0;
+	if (!m_prefixIndex->findRange(prefix, first, last))
+	{
+		TRACE("Type-ahead: no items for prefix '%s'", prefix.c_str());
+		return result;
+	}
+
+	m_typeAhead = prefix;
+	m_filter.setRange(m_unfilteredSource, m_prefixIndex, first, last);
+
+	DEBUG("Type-ahead: '%s' - %d item(s)", m_typeAhead.c_str(), last - first);
+
+	applyDataSource(&m_filter, 0);
+	result = true;
+
+	return result;
+}
@@ -3,39 +3,42 @@
 
 #include <string>
 #include <vector>
+#include <stdint.h>
+#include "../../../common/helpers/prefixindex.h"
+#include "../../../interfaces/ilistdatasource.h"
+#include "prefixfilterdatasource.h"
 
 using namespace std;
 
-struct ListItem
-{
-	// Item name to display
-	string name;
-
-	// Associated value
-	int value;
-
-	// Enabled / disabled flag (Disabled items cannot be selected and grayed-out visually)
-	bool disabled = false;
-
-	ListItem() {};
-	ListItem(const string& name, int value, bool disabled): name(name), value(value), disabled(disabled) {};
-};
-typedef struct ListItem ListItem;
-typedef vector<ListItem> ListItemVector;
-
+// List control with virtualized data: only visible rows (plus PREFETCH_ROWS above and below) are materialized
+// from the data source, so memory and open time don't depend on the number of items
 class SelectionList
 {
 protected:
+	static const int PREFETCH_ROWS = 8;
+
 	// Control boundaries
 	const int m_left;
 	const int m_top;
 	const int m_width;
 	const int m_height;
 
-	// DataSource
-	ListItemVector m_data;
+	// DataSource (not owned)
+	IListDataSource* m_dataSource = nullptr;
+	int m_count = 0;
 	int m_selectedIndex = -1;
 
+	// Type-ahead (list is narrowed to items starting with m_typeAhead while it's not empty)
+	IListDataSource* m_unfilteredSource = nullptr;
+	const PrefixIndex* m_prefixIndex = nullptr;
+	PrefixFilterDataSource m_filter;
+	string m_typeAhead;
+	uint64_t m_lastTypeAhead = 0;
+
+	// Materialized items window [m_cacheStart, m_cacheStart + m_cache.size())
+	ListItemVector m_cache;
+	int m_cacheStart = 0;
+
 	// Context
 	int m_topIndex = -1;				// What record displayed in the very first line
 	int m_selectedOnScreenPos = -1;	// What line is currently highlighted on-screen (y-pos in lines)
@@ -51,10 +54,20 @@ public:
 
 // Public methods
 public:
-	void setDataSource(const ListItemVector& data);
+	void setDataSource(IListDataSource* dataSource);
+	void reload();
+	void setPrefixIndex(const PrefixIndex* index);
 	int getSelectedIndex();
+	void setSelectedIndex(int index);
+	int getSelectedSourceIndex();
 	const ListItem* getSelectedItem();
 
+	// Type-ahead
+	const string& getTypeAhead();
+	bool typeAhead(char symbol);
+	bool eraseTypeAhead();
+	bool resetTypeAhead();
+
 // Control methods
 public:
 	void pageUp();
@@ -63,13 +76,17 @@ public:
 	void moveDown();
 	void enter();
 	void cancel();
+	void tick();
 
 // Helper methods
 protected:
+	void applyDataSource(IListDataSource* dataSource, int selectedIndex, int topIndex = 0);
+	bool applyTypeAhead(const string& prefix);
 	void drawContent();
 	void drawScrollBar();
 	void removeSelectedHighlight();
 	void recalcPosition();
+	const ListItem* fetchItem(int index);
 };
 
 #endif /* GUI_MENU_CONTROLS_SELECTIONLIST_H_ */
@@ -6,20 +6,95 @@
 #include "../../common/file/path/path.h"
 #include "../../common/helpers/collectionhelper.h"
 #include "../osd/osd.h"
+#include "../osd/osdpresenter.h"
 #include "../../cores/coremanager.h"
 #include "../../fpga/fpgadevice.h"
 #include "../../fpga/fpgacommand.h"
 #include "../../system/hdmi/hdmipll.h"
 
+// Cores folder is scanned asynchronously: list is populated progressively (see onFolderScan).
+// Each start re-reads cores (folder may be changed meanwhile) and redraws the list, since OSD content could be
+// overwritten while menu was closed. Unchanged folder is served from the index, so it's cheap
 void CoreSelectionMenu::start()
 {
-	auto list = readAvailableCores();
-	m_ctrlSelectionList->setDataSource(list);
+	m_isScanned = false;
+	m_coreNames.clear();
+	m_prefixIndex.clear();
+	m_ctrlSelectionList->setDataSource(this);
+
+	// Get all .rbf cores (except menu.rbf), sorted in natural order ("Core 2" before "Core 10")
+	// Listing is taken from folder index while cores folder is not changed
+	m_scanner.start(DATA_ROOT, ScanDir::getFPGACoreFilter(), AsyncScanDir::getNaturalSort(), "fpga_cores:natural");
 }
 
+// Menu is closed - unfinished scan is not needed anymore (will be restarted on next start)
 void CoreSelectionMenu::stop()
 {
+	m_scanner.cancel();
+}
+
+void CoreSelectionMenu::onFolderScan(const FolderScanEvent& event)
+{
+	// Notification from cancelled scan
+	if (event.scanId != m_scanner.getScanId())
+		return;
+
+	if (!event.isCompleted)
+	{
+		size_t from = m_coreNames.size();
+
+		if (m_scanner.fetchEntries(m_coreNames))
+		{
+			prepareEntries(from);
+
+			m_ctrlSelectionList->reload();
+		}
+	}
+	else
+	{
+		// Item selected while entries were arriving should stay selected after sorting
+		int selectedIndex = m_ctrlSelectionList->getSelectedSourceIndex();
+		string selectedName = selectedIndex >= 0 && selectedIndex < (int)m_coreNames.size() ? m_coreNames[selectedIndex].name : "";
+
+		if (!m_scanner.fetchSorted(m_coreNames))
+			return;
 
+		m_isScanned = true;
+
+		prepareEntries(0);
+
+		// Entries order is changed - list is reloaded, type-ahead becomes available
+		m_prefixIndex.clear();
+		m_prefixIndex.reserve(m_coreNames.size());
+		for (const DirectoryEntry& entry : m_coreNames)
+		{
+			m_prefixIndex.add(entry.displayname);
+		}
+		m_prefixIndex.build();
+
+		m_ctrlSelectionList->setDataSource(this);
+		m_ctrlSelectionList->setPrefixIndex(&m_prefixIndex);
+
+		if (!selectedName.empty())
+		{
+			auto it = find_if(m_coreNames.begin(), m_coreNames.end(),
+				[&selectedName](const DirectoryEntry& entry) { return entry.name == selectedName; });
+
+			if (it != m_coreNames.end())
+			{
+				m_ctrlSelectionList->setSelectedIndex(it - m_coreNames.begin());
+			}
+		}
+
+		if (m_coreNames.size() > 0)
+		{
+			LOGINFO("%d cores available", m_coreNames.size());
+		}
+		else
+		{
+			LOGINFO("No FPGA cores available \n");
+		}
+	}
 }
 
 DirectoryEntryVector& CoreSelectionMenu::getAvailableCores()
@@ -67,12 +142,17 @@ void CoreSelectionMenu::enter()
 {
 	m_ctrlSelectionList->enter();
 
-	int selectedIndex = m_ctrlSelectionList->getSelectedIndex();
+	int selectedIndex = m_ctrlSelectionList->getSelectedSourceIndex();
 
 	if (selectedIndex >= 0)
 	{
-		// Close OSD now as the new core may not even have one
-		OSD::instance().hide();
+		OSD& osd = OSD::instance();
+		OSDPresenter& presenter = OSDPresenter::instance();
+
+		// Close OSD now as the new core may not even have one. OSD disable has to reach the current core,
+		// then presenter should stay away from FPGA bus while it's being reconfigured
+		osd.hide();
+		presenter.suspend();
 
 		const DirectoryEntry& item = m_coreNames[selectedIndex];
 		const string filename = item.name;
@@ -80,6 +160,9 @@ void CoreSelectionMenu::enter()
 		// Load FPGA core from file
 		CoreManager::instance().loadCore(filename);
 
+		// New core has its own OSD buffer
+		osd.invalidate();
+
 		// Post-load and core set-up activities
 		FPGACommand& command = *FPGADevice::instance().command;
 
@@ -97,7 +180,13 @@ void CoreSelectionMenu::enter()
 		//HDMIPLL::setStandardVideoMode(0); // 1280x720 @ 60 Hz
 
 		// 3. Send UIO_BUT_SW command after all 8 VESA params sent to FPGA side to have settings applied (works as latch)
-		command.sendIOCommand(UIO_BUT_SW, (uint16_t)0);
+		// Set-up commands wait for transfers in progress instead of being dropped
+		if (command.startIO(true))
+		{
+			command.sendCommand(UIO_BUT_SW, (uint16_t)0);
+
+			command.endIO();
+		}
 
 		// 4. [Optional] step to apply saved settings and ROM files for the core
 
@@ -107,49 +196,65 @@ void CoreSelectionMenu::enter()
 
 		// Control if video mode set successfully
 		LOGINFO("%s", command.getVideoMode().c_str());
+
+		presenter.resume();
 	}
 }
 
+// First cancel drops type-ahead filter (if any)
 void CoreSelectionMenu::cancel()
 {
-	m_ctrlSelectionList->cancel();
+	if (!m_ctrlSelectionList->resetTypeAhead())
+	{
+		m_ctrlSelectionList->cancel();
+	}
 }
 
-// Helper methods
-ListItemVector CoreSelectionMenu::readAvailableCores()
+void CoreSelectionMenu::tick()
 {
-	ListItemVector result;
+	m_ctrlSelectionList->tick();
+}
 
-	// Get all .rbf cores (except menu.rbf), sorted alphabetically in ascending order
-	ScanDir scan;
-	scan.scanFolder(DATA_ROOT, ScanDir::getFPGACoreFilter(), ScanDir::getAlphaSortCaseInsensitive());
+void CoreSelectionMenu::typeAhead(char symbol)
+{
+	m_ctrlSelectionList->typeAhead(symbol);
+}
 
-	m_coreNames = scan.getScanResults();
+void CoreSelectionMenu::eraseTypeAhead()
+{
+	m_ctrlSelectionList->eraseTypeAhead();
+}
 
-	// Strip extensions from displayname property
-	if (m_coreNames.size() > 0)
-	{
-		for_each(m_coreNames.begin(), m_coreNames.end(),
-			[&](DirectoryEntry& entry)
-			{
-				entry.displayname = Path::getFileNameWithoutExtension(entry.displayname);
+// IListDataSource implementation
+int CoreSelectionMenu::getItemCount()
+{
+	return m_coreNames.size();
+}
 
-				ListItem item(entry.displayname, 0, false);
-				result.push_back(item);
-			}
-		);
+bool CoreSelectionMenu::getItem(int index, ListItem& item)
+{
+	bool result = false;
 
-		LOGINFO("%d cores available", result.size());
-	}
-	else
-	{
-		LOGINFO("No FPGA cores available \n");
-	}
+	if (index < 0 || index >= (int)m_coreNames.size())
+		return result;
 
-	// Free up ScanDir buffers
-	scan.dispose();
+	item.name = m_coreNames[index].displayname;
+	item.value = index;
+	item.disabled = false;
+	result = true;
 
 	return result;
 }
 
+// Helper methods
 
+// Strip extensions from displayname property (entries starting from <from>, scanner provides raw names)
+void CoreSelectionMenu::prepareEntries(size_t from)
+{
+	for_each(m_coreNames.begin() + from, m_coreNames.end(),
+		[&](DirectoryEntry& entry)
+		{
+			entry.displayname = Path::getFileNameWithoutExtension(entry.displayname);
+		}
+	);
+}
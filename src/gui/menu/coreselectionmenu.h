@@ -4,18 +4,26 @@
 #include <string>
 #include <vector>
 #include "../../common/consts.h"
+#include "../../common/messagetypes.h"
 #include "../../common/file/scandir/scandir.h"
+#include "../../common/file/scandir/asyncscandir.h"
+#include "../../common/helpers/prefixindex.h"
+#include "../../interfaces/ilistdatasource.h"
 #include "basemenu.h"
 #include "controls/selectionlist.h"
 
 using namespace std;
 
-class CoreSelectionMenu : public BaseMenu
+// Cores list is the only copy of the data: SelectionList fetches visible items from it on demand
+class CoreSelectionMenu : public BaseMenu, public IListDataSource
 {
 public:
 	SelectionList* m_ctrlSelectionList;
 
+	AsyncScanDir m_scanner;
 	DirectoryEntryVector m_coreNames;
+	bool m_isScanned = false;
+	PrefixIndex m_prefixIndex;		// Type-ahead index over core display names (built once per scan)
 	string m_selectedItem;
 	int m_selectedIndex;
 
@@ -34,6 +42,7 @@ public:
 
 	void start();
 	void stop();
+	void onFolderScan(const FolderScanEvent& event);
 
 	DirectoryEntryVector& getAvailableCores();
 	void selectItem(int index);
@@ -46,10 +55,18 @@ public:
 	void moveDown();
 	void enter();
 	void cancel();
+	void tick();
+	void typeAhead(char symbol);
+	void eraseTypeAhead();
+
+// IListDataSource implementation
+public:
+	int getItemCount();
+	bool getItem(int index, ListItem& item);
 
 // Helper methods
 protected:
-	ListItemVector readAvailableCores();
+	void prepareEntries(size_t from);
 };
 
 #endif /* GUI_MENU_CORESELECTIONMENU_H_ */
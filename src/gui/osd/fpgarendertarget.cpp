@@ -0,0 +1,122 @@
+#include "fpgarendertarget.h"
+
+#include "../../common/logger/logger.h"
+
+#include "osd.h"
+#include "../../fpga/fpgadevice.h"
+#include "../../fpga/fpgacommand.h"
+
+const char* FPGARenderTarget::getName()
+{
+	return "fpga";
+}
+
+// Enable / disable core OSD. Returns false if FPGA is busy with other command (presenter retries)
+bool FPGARenderTarget::setVisibility(OSDVisibility visibility)
+{
+	bool result = true;
+
+	FPGADevice& fpga = FPGADevice::instance();
+	if (fpga.command == nullptr)	// Headless mode (no FPGA) - nothing to show or hide
+		return result;
+
+	FPGACommand& command = *(fpga.command);
+
+	result = command.startOSD();
+	if (!result)
+		return result;
+
+	if (visibility == OSDVisibility::Hidden)
+	{
+		command.sendCommand(MM1_OSDCMDDISABLE);
+	}
+	else
+	{
+		command.sendCommand(MM1_OSDCMDENABLE);
+
+		if (visibility == OSDVisibility::ShownHighres)
+		{
+			command.nextOSD();
+			command.sendCommand(OSD_CMD_OSD);
+		}
+	}
+
+	command.endOSD();
+
+	return result;
+}
+
+/*
+ * Each line (256 bytes) is sent with line-addressed write (MM1_OSDCMDWRITE | line), ~0.4ms per line,
+ * the whole framebuffer - with single command starting from line 0 (~6.1ms). Both times are halved
+ * if the core supports wide (16-bit) transfers
+ */
+bool FPGARenderTarget::present(const uint8_t* frame, uint8_t lineCount, uint16_t lineLength, uint32_t lines, uint64_t /*timestamp*/)
+{
+	bool result = false;
+
+	if (frame == nullptr)
+		return result;
+
+	FPGADevice& fpga = FPGADevice::instance();
+	if (fpga.command == nullptr)	// Headless mode (no FPGA) - nothing to transfer, frame isn't kept pending
+	{
+		result = true;
+		return result;
+	}
+
+	FPGACommand& command = *(fpga.command);
+
+	uint32_t allLines = (1u << lineCount) - 1;
+	unsigned count = 0;
+	for (uint8_t line = 0; line < lineCount; line++)
+	{
+		count += (lines >> line) & 1;
+	}
+
+	// Full transfer has a single command overhead
+	bool isFull = count > FULL_TRANSFER_LINES || (lines & allLines) == allLines;
+
+	// FPGA is busy with other command - presenter retries shortly
+	if (!command.startOSD())
+	{
+		TRACE("%s: FPGA is busy, OSD buffer transfer postponed", __PRETTY_FUNCTION__);
+		return result;
+	}
+
+	TRACE("OSD buffer transfer started (lines: 0x%04x)", lines);
+
+	if (isFull)
+	{
+		// Write to buffer command (Line is selected as render start MM1_OSDCMDWRITE | 0). Buffer is written continuously
+		command.sendCommand(MM1_OSDCMDWRITE);
+		command.sendData(frame, lineCount * lineLength);
+	}
+	else
+	{
+		bool isFirst = true;
+
+		for (uint8_t line = 0; line < lineCount; line++)
+		{
+			if (!(lines & (1u << line)))
+				continue;
+
+			if (!isFirst)
+			{
+				command.nextOSD();
+			}
+
+			command.sendCommand(MM1_OSDCMDWRITE | line);
+			command.sendData(frame + line * lineLength, lineLength);
+
+			isFirst = false;
+		}
+	}
+
+	command.endOSD();
+	result = true;
+
+	TRACE("OSD buffer transfer finished");
+
+	return result;
+}
@@ -0,0 +1,27 @@
+#ifndef GUI_OSD_FPGARENDERTARGET_H_
+#define GUI_OSD_FPGARENDERTARGET_H_
+
+#include <stdint.h>
+#include "../../interfaces/iosdrendertarget.h"
+#include "osd.h"
+
+// Sends OSD frames to the core OSD module. Only changed lines are transferred (line-addressed writes),
+// the whole frame - with single command if most of the lines changed
+class FPGARenderTarget : public IOSDRenderTarget
+{
+protected:
+	static const uint8_t FULL_TRANSFER_LINES = 12;		// Send the whole frame with single command if more lines changed
+
+public:
+	FPGARenderTarget() {};
+	virtual ~FPGARenderTarget() {};
+
+	bool setVisibility(OSDVisibility visibility);
+
+// IOSDRenderTarget implementation
+public:
+	const char* getName();
+	bool present(const uint8_t* frame, uint8_t lineCount, uint16_t lineLength, uint32_t lines, uint64_t timestamp);
+};
+
+#endif /* GUI_OSD_FPGARENDERTARGET_H_ */
@@ -0,0 +1,116 @@
+#include "glyphatlas.h"
+
+#include "../../common/logger/logger.h"
+
+#include <string.h>
+#include "characters.h"
+
+// Out-of-class definitions for constants (required for C++14 if constant is odr-used)
+constexpr uint16_t GlyphAtlas::GLYPH_COUNT;
+constexpr uint8_t GlyphAtlas::GLYPH_FALLBACK;
+
+GlyphAtlas& GlyphAtlas::instance()
+{
+	static GlyphAtlas instance;
+
+	return instance;
+}
+
+GlyphAtlas::GlyphAtlas()
+{
+	build();
+}
+
+// Rotate 8x8 pixels block counter-clockwise. Title strip is rotated after scaling and condensing,
+// so it's done over title buffer blocks instead of single glyphs
+void GlyphAtlas::rotate(const uint8_t* in, uint8_t* out)
+{
+	uint8_t value;
+
+	for (int i = 0; i < 8; i++)
+	{
+		value = 0;
+		for (int j = 0; j < 8; j++)
+		{
+			value <<= 1;
+			value |= (in[j] >> i) & 1;
+		}
+
+		out[i] = value;
+	}
+}
+
+// Helper methods
+
+void GlyphAtlas::build()
+{
+	for (unsigned symbol = 0; symbol < GLYPH_COUNT; symbol++)
+	{
+		Glyph& glyph = m_glyphs[symbol];
+		const uint8_t* columns = charfont[symbol];
+
+		memcpy(glyph.normal, columns, sizeof(glyph.normal));
+
+		for (int i = 0; i < 8; i++)
+		{
+			glyph.inverted[i] = ~columns[i];
+
+			// Each column doubled horizontally, each pixel - vertically
+			uint16_t scaledWord = scale8Bits(columns[i]);
+			glyph.scaled[0][i * 2] = (uint8_t)scaledWord;
+			glyph.scaled[0][i * 2 + 1] = (uint8_t)scaledWord;
+			glyph.scaled[1][i * 2] = (uint8_t)(scaledWord >> 8);
+			glyph.scaled[1][i * 2 + 1] = (uint8_t)(scaledWord >> 8);
+		}
+
+		trim(columns, glyph.trimOffset, glyph.trimWidth);
+	}
+
+	DEBUG("%s: %d glyphs prepared (%d bytes)", __PRETTY_FUNCTION__, GLYPH_COUNT, sizeof(m_glyphs));
+}
+
+// Determine true symbol width (trimming empty columns on both sides)
+// Only left and right 3 pixel columns are processed (center 2 pixels shouldn't be compressed - Space symbol for example)
+void GlyphAtlas::trim(const uint8_t* columns, uint8_t& offset, uint8_t& width)
+{
+	offset = 0;
+	width = 8;
+
+	bool isContinuousLeft = columns[0] == 0;
+	bool isContinuousRight = columns[7] == 0;
+	for (int i = 0; i < 3; i++)
+	{
+		// Process left half
+		if (columns[i] == 0 && isContinuousLeft)
+		{
+			offset++;
+			width--;
+		}
+		else
+			isContinuousLeft = false;
+
+		// Process right half
+		if (columns[7 - i] == 0 && isContinuousRight)
+		{
+			width--;
+		}
+		else
+			isContinuousRight = false;
+	}
+}
+
+// Each bit is doubled: b7..b0 => b7b7..b0b0
+uint16_t GlyphAtlas::scale8Bits(uint8_t byte)
+{
+	uint16_t result = 0;
+
+	for (int i = 0; i < 8; i++)
+	{
+		if (byte & (1 << i))
+		{
+			result |= 0x3 << (i * 2);
+		}
+	}
+
+	return result;
+}
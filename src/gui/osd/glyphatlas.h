@@ -0,0 +1,64 @@
+#ifndef GUI_OSD_GLYPHATLAS_H_
+#define GUI_OSD_GLYPHATLAS_H_
+
+#include <stdint.h>
+
+using namespace std;
+
+// All pre-rendered variants of single font symbol (columns, LSB - top pixel, same as in framebuffer)
+struct Glyph
+{
+	uint8_t normal[8];
+	uint8_t inverted[8];
+	uint8_t scaled[2][16];		// 2x scaled: [upper / lower framebuffer line][column]
+
+	// Non-empty columns range (up to 3 empty columns trimmed on each side, used for condensed title text)
+	uint8_t trimOffset;
+	uint8_t trimWidth;
+};
+typedef struct Glyph Glyph;
+
+// Glyph variants are built once on startup from charfont, so text / title rendering is just copying prepared columns
+class GlyphAtlas
+{
+public:
+	static constexpr uint16_t GLYPH_COUNT = 128;
+	static constexpr uint8_t GLYPH_FALLBACK = '?';	// Used for symbols outside of the font
+
+protected:
+	Glyph m_glyphs[GLYPH_COUNT];
+
+public:
+	// Singleton instance
+	static GlyphAtlas& instance();
+	GlyphAtlas(GlyphAtlas&&) = delete;						// Disable move constructor (C++11 feature)
+	GlyphAtlas(const GlyphAtlas& that) = delete; 			// Disable copy constructor (C++11 feature)
+	GlyphAtlas& operator =(GlyphAtlas const&) = delete;		// Disable assignment operator (C++11 feature)
+	virtual ~GlyphAtlas() {};
+
+	inline const Glyph& get(uint8_t symbol) const
+	{
+		return m_glyphs[symbol < GLYPH_COUNT ? symbol : GLYPH_FALLBACK];
+	}
+
+	inline const uint8_t* getColumns(uint8_t symbol, bool invert) const
+	{
+		const Glyph& glyph = get(symbol);
+
+		return invert ? glyph.inverted : glyph.normal;
+	}
+
+	static void rotate(const uint8_t* in, uint8_t* out);
+
+// Helper methods
+protected:
+	void build();
+
+	static void trim(const uint8_t* columns, uint8_t& offset, uint8_t& width);
+	static uint16_t scale8Bits(uint8_t byte);
+
+private:
+	GlyphAtlas();	// Disable explicit object creation (only singleton instance allowed)
+};
+
+#endif /* GUI_OSD_GLYPHATLAS_H_ */
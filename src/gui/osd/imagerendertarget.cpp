@@ -0,0 +1,131 @@
+#include "imagerendertarget.h"
+
+#include "../../common/logger/logger.h"
+
+#include <fstream>
+#include <sstream>
+#include "../../common/file/path/path.h"
+
+uint32_t ImageRenderTarget::getFramesWritten()
+{
+	return m_framesWritten;
+}
+
+// Only valid while presenter is idle (file name is updated by presenter thread)
+const string& ImageRenderTarget::getLastFile()
+{
+	return m_lastFile;
+}
+
+// Convert OSD frame into image file content. Image is <lineLength> x <lineCount * 8> pixels
+string ImageRenderTarget::render(const uint8_t* frame, uint8_t lineCount, uint16_t lineLength, uint64_t timestamp, OSDImageFormatEnum format)
+{
+	string result;
+
+	if (frame == nullptr)
+		return result;
+
+	uint16_t width = lineLength;
+	uint16_t height = lineCount * 8;
+
+	stringstream ss;
+
+	switch (format)
+	{
+		case OSDImageFormatEnum::PGM:
+			ss << "P5\n# timestamp " << timestamp << "\n" << width << " " << height << "\n255\n";
+			result = ss.str();
+			result.reserve(result.size() + width * height);
+
+			for (uint16_t y = 0; y < height; y++)
+			{
+				for (uint16_t x = 0; x < width; x++)
+				{
+					result.push_back(isPixelSet(frame, lineLength, x, y) ? (char)0xFF : (char)0x00);
+				}
+			}
+			break;
+		case OSDImageFormatEnum::ASCII:
+			ss << "# timestamp " << timestamp << " size " << width << "x" << height << "\n";
+			result = ss.str();
+			result.reserve(result.size() + (width + 1) * height);
+
+			for (uint16_t y = 0; y < height; y++)
+			{
+				for (uint16_t x = 0; x < width; x++)
+				{
+					result.push_back(isPixelSet(frame, lineLength, x, y) ? '#' : '.');
+				}
+
+				result.push_back('\n');
+			}
+			break;
+		default:
+			LOGERROR("%s: unsupported image format '%s'", __PRETTY_FUNCTION__, format._to_string());
+			break;
+	}
+
+	return result;
+}
+
+// IOSDRenderTarget implementation
+
+const char* ImageRenderTarget::getName()
+{
+	return "image";
+}
+
+// Every presented frame is written completely (changed lines mask is ignored)
+bool ImageRenderTarget::present(const uint8_t* frame, uint8_t lineCount, uint16_t lineLength, uint32_t /*lines*/, uint64_t timestamp)
+{
+	bool result = false;
+
+	string content = render(frame, lineCount, lineLength, timestamp, m_format);
+	if (content.empty())
+		return result;
+
+	stringstream ss;
+	ss << "osd_" << m_framesWritten << "_" << timestamp << "." << getExtension(m_format);
+	string path = Path::combine(m_folder, ss.str()).toString();
+
+	ofstream file(path, ios::out | ios::binary | ios::trunc);
+	if (file.is_open())
+	{
+		file.write(content.data(), content.size());
+		file.close();
+
+		m_lastFile = path;
+		m_framesWritten++;
+	}
+	else
+	{
+		LOGERROR("%s: unable to write OSD image to '%s'", __PRETTY_FUNCTION__, path.c_str());
+	}
+
+	// Image write failures shouldn't stall presentation to other targets, so frame is never reported as pending
+	result = true;
+
+	return result;
+}
+
+// Helper methods
+
+const char* ImageRenderTarget::getExtension(OSDImageFormatEnum format)
+{
+	const char* result = "txt";
+
+	if (format == +OSDImageFormatEnum::PGM)
+	{
+		result = "pgm";
+	}
+
+	return result;
+}
+
+// Each framebuffer byte holds 8 vertical pixels of the line (LSB - top)
+bool ImageRenderTarget::isPixelSet(const uint8_t* frame, uint16_t lineLength, uint16_t x, uint16_t y)
+{
+	bool result = (frame[(y >> 3) * lineLength + x] >> (y & 0x07)) & 0x01;
+
+	return result;
+}
@@ -0,0 +1,43 @@
+#ifndef GUI_OSD_IMAGERENDERTARGET_H_
+#define GUI_OSD_IMAGERENDERTARGET_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include "../../common/types.h"
+#include "../../interfaces/iosdrendertarget.h"
+
+using namespace std;
+
+// Writes each presented OSD frame into <folder> as an image file (osd_<frame>_<timestamp>.<ext>).
+// Allows to run and benchmark OSD rendering without FPGA, and to compare results with golden images
+class ImageRenderTarget : public IOSDRenderTarget
+{
+protected:
+	string m_folder;
+	OSDImageFormatEnum m_format;
+
+	atomic<uint32_t> m_framesWritten { 0 };
+	string m_lastFile;
+
+public:
+	ImageRenderTarget(const string& folder, OSDImageFormatEnum format = OSDImageFormatEnum::PGM) : m_folder(folder), m_format(format) {};
+	virtual ~ImageRenderTarget() {};
+
+	uint32_t getFramesWritten();
+	const string& getLastFile();
+
+	static string render(const uint8_t* frame, uint8_t lineCount, uint16_t lineLength, uint64_t timestamp, OSDImageFormatEnum format);
+
+// IOSDRenderTarget implementation
+public:
+	const char* getName();
+	bool present(const uint8_t* frame, uint8_t lineCount, uint16_t lineLength, uint32_t lines, uint64_t timestamp);
+
+// Helper methods
+protected:
+	static const char* getExtension(OSDImageFormatEnum format);
+	static bool isPixelSet(const uint8_t* frame, uint16_t lineLength, uint16_t x, uint16_t y);
+};
+
+#endif /* GUI_OSD_IMAGERENDERTARGET_H_ */
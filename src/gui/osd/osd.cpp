@@ -6,11 +6,33 @@
 #include <string.h>
 #include <stdio.h>
 
-#include "characters.h"
+#include "../../common/consts.h"
+#include "glyphatlas.h"
+#include "osdpresenter.h"
 #include "../../fpga/fpgadevice.h"
 #include "../../fpga/fpgaconnector.h"
 #include "../../fpga/fpgacommand.h"
 
+// Word access helpers (memcpy keeps it free from alignment / aliasing issues, compiles into single ldr / str)
+static inline uint32_t load32(const uint8_t* data)
+{
+	uint32_t result;
+	memcpy(&result, data, sizeof(result));
+
+	return result;
+}
+
+static inline void store32(uint8_t* data, uint32_t value)
+{
+	memcpy(data, &value, sizeof(value));
+}
+
+// Byte value repeated in each of 4 word bytes
+static inline uint32_t replicate(uint8_t value)
+{
+	return value * 0x01010101u;
+}
+
 OSD& OSD::instance()
 {
 	static OSD instance;
@@ -22,37 +44,50 @@ OSD::~OSD()
 {
 }
 
+// OSD is enabled by presenter right after pending frame transfer, so stale content is never shown
 void OSD::show()
 {
-	FPGADevice& fpga = FPGADevice::instance();
-	FPGACommand& command = *(fpga.command);
+	if (visibility == OSDVisibility::Shown)
+		return;
 
-	command.sendOSDCommand(MM1_OSDCMDENABLE);
+	visibility = OSDVisibility::Shown;
+
+	// Content could be changed while OSD was hidden - first composition after show will be the full one
+	invalidate();
+
+	OSDPresenter::instance().setVisibility(visibility);
 }
 
 void OSD::showHighres()
 {
-	FPGADevice& fpga = FPGADevice::instance();
-	FPGACommand& command = *(fpga.command);
+	if (visibility == OSDVisibility::ShownHighres)
+		return;
+
+	visibility = OSDVisibility::ShownHighres;
 
-	command.sendOSDCommand(MM1_OSDCMDENABLE);
-	command.sendOSDCommand(OSD_CMD_OSD);
+	// Content could be changed while OSD was hidden - first composition after show will be the full one
+	invalidate();
+
+	OSDPresenter::instance().setVisibility(visibility);
 }
 
 void OSD::hide()
 {
-	FPGADevice& fpga = FPGADevice::instance();
-	FPGACommand& command = *(fpga.command);
+	if (visibility == OSDVisibility::Hidden)
+		return;
 
-	command.sendOSDCommand(MM1_OSDCMDDISABLE);
+	visibility = OSDVisibility::Hidden;
+
+	OSDPresenter::instance().setVisibility(visibility);
 }
 
 void OSD::fill()
 {
 	memset(framebuffer, 0xAA, sizeof(framebuffer));
+	markDirty(0, OSD_HIGHRES_HEIGHT_LINES - 1);
 
 	// Transfer changes to FPGA
-	transferFramebuffer();
+	commitFramebuffer();
 }
 
 void OSD::clear()
@@ -76,12 +111,18 @@ void OSD::compose()
 	{
 		for (unsigned x = 0; x < OSD_HIGHRES_TITLE_WIDTH_PX; x += 8)
 		{
-			//rotateCharacter(&titlebuffer[y][x], &framebuffer[OSD_HIGHRES_HEIGHT_PX - x][y]);
+			//GlyphAtlas::rotate(&titlebuffer[y][x], &framebuffer[OSD_HIGHRES_HEIGHT_PX - x][y]);
 		}
 	}
 	*/
 
-	transferFramebuffer();
+	commitFramebuffer();
+}
+
+// FPGA side framebuffer content is not known anymore (e.g. OSD was used by the core), so next transfer is a full one
+void OSD::invalidate()
+{
+	OSDPresenter::instance().invalidate();
 }
 
 void OSD::setTitle(const string& title, uint8_t arrows)
@@ -91,64 +132,24 @@ void OSD::setTitle(const string& title, uint8_t arrows)
 
 	memset(titlebuffer, 0, sizeof(titlebuffer));
 
-	// Print 2x scaled symbols into title buffer, condensing extra empty columns
-	while (true)
+	const GlyphAtlas& atlas = GlyphAtlas::instance();
+	const unsigned limit = sizeof(titlebuffer[0]);
+
+	// Copy 2x scaled symbols into title buffer, condensing extra empty columns
+	while (xOffset < limit)
 	{
 		uint8_t symbol = title[idx++];
 		if (symbol == '\0')
 			break;
 
-		TRACE("Title symbol '%c'", symbol);
-
-		// Determine true symbol width (trimming empty columns on both sides)
-		uint8_t startOffset = 0;
-		uint8_t width = 8;
-		{
-			// Process left and right 3 pixel columns (center 2 pixels shouldn't be compressed - Space symbol for example)
-			bool isContinuousLeft = charfont[symbol][0] == 0;
-			bool isContinuousRight = charfont[symbol][7] == 0;
-			for (int i = 0; i < 3; i++)
-			{
-				uint8_t fontByte = charfont[symbol][i];
-				uint8_t fontByteRev = charfont[symbol][7 - i];
-
-				// Process left half
-				if (fontByte == 0 && isContinuousLeft)
-				{
-					startOffset++;
-					width--;
-				}
-				else
-					isContinuousLeft = false;
-
-				// Process right half
-				if (fontByteRev == 0 && isContinuousRight)
-				{
-					width--;
-				}
-				else
-					isContinuousRight = false;
-			}
-		}
-
-		// Print scaled symbol into title buffer
-		{
-			for (int i = startOffset; i < startOffset + width; i++)
-			{
-				uint8_t fontByte = charfont[symbol][i];
-				uint16_t scaledWord = scale8Bits(fontByte);
-
-				titlebuffer[0][xOffset] = (uint8_t)scaledWord;
-				titlebuffer[0][xOffset + 1] = (uint8_t)scaledWord;
-				titlebuffer[1][xOffset] = (uint8_t)(scaledWord >> 8);
-				titlebuffer[1][xOffset + 1] = (uint8_t)(scaledWord >> 8);
+		const Glyph& glyph = atlas.get(symbol);
+		unsigned length = glyph.trimWidth * 2;
+		length = xOffset + length > limit ? limit - xOffset : length;
 
-				xOffset += 2;
-			}
-		}
+		memcpy(&titlebuffer[0][xOffset], &glyph.scaled[0][glyph.trimOffset * 2], length);
+		memcpy(&titlebuffer[1][xOffset], &glyph.scaled[1][glyph.trimOffset * 2], length);
 
-		if (xOffset >= OSD_HIGHRES_HEIGHT_LINES * 8)
-			break;
+		xOffset += length;
 	}
 }
 
@@ -158,23 +159,21 @@ void OSD::printLine(uint8_t line, const string& text, bool invert)
 	if (line >= heightLimit)
 		return;
 
+	markDirty(line, line);
+
 	unsigned i = 0;
 	int curOffset = 16; // (in px). Make 2 symbols right shift (since will be overlapped with title anyway)
 
+	const GlyphAtlas& atlas = GlyphAtlas::instance();
+
 	while (i < text.size())
 	{
 		uint8_t symbol = text[i++];
 
 		if (curOffset < OSD_LINE_LENGTH_BYTES)
 		{
-			for (int j = 0; j < 8; ++j)
-			{
-				uint8_t fontByte = charfont[symbol][j];
-				if (invert)
-					fontByte = ~fontByte;
-
-				framebuffer[line][curOffset++] = fontByte;
-			}
+			memcpy(&framebuffer[line][curOffset], atlas.getColumns(symbol, invert), 8);
+			curOffset += 8;
 		}
 		else
 		{
@@ -183,6 +182,90 @@ void OSD::printLine(uint8_t line, const string& text, bool invert)
 	}
 }
 
+// Text is expected to be drawn already at <left> of <line> (as printLine / printSymbol do), scrolling continues from there.
+// Nothing happens if text fits into <width> pixels
+void OSD::startTextScroll(uint8_t line, uint16_t left, uint16_t width, const string& text, bool invert)
+{
+	stopTextScroll();
+
+	if (line >= OSD_HIGHRES_HEIGHT_LINES || left >= OSD_LINE_LENGTH_BYTES || width == 0)
+		return;
+
+	width = left + width > OSD_LINE_LENGTH_BYTES ? OSD_LINE_LENGTH_BYTES - left : width;
+	if (text.size() * 8 <= width)
+		return;
+
+	scroll_line = line;
+	scroll_left = left;
+	scroll_width = width;
+	scroll_text = text;
+	scroll_invert = invert;
+	scroll_offset = 0;
+	scroll_timer = OSD_SCROLL_PAUSE;
+	scroll_active = true;
+}
+
+void OSD::stopTextScroll()
+{
+	scroll_active = false;
+	scroll_text.clear();
+}
+
+bool OSD::isTextScrolling()
+{
+	return scroll_active;
+}
+
+/*
+ * Move scrolling text one pixel column left. Since each framebuffer byte is a pixel column, existing columns
+ * are shifted with a single memmove and only the newly exposed rightmost column is rendered from glyph atlas.
+ * Only the scrolling line is marked dirty, so just that line is transferred on each step.
+ * Text runs as a loop (with OSD_SCROLL_GAP empty symbols between the end and the start) and pauses each time
+ * it returns to the start. Returns true if framebuffer was changed
+ */
+bool OSD::scrollTextStep()
+{
+	bool result = false;
+
+	if (!scroll_active)
+		return result;
+
+	if (scroll_timer > 0)
+	{
+		scroll_timer--;
+		return result;
+	}
+
+	const uint32_t length = (scroll_text.size() + OSD_SCROLL_GAP) * 8;
+	scroll_offset = (scroll_offset + 1) % length;
+
+	uint8_t* data = &framebuffer[scroll_line][scroll_left];
+	memmove(data, data + 1, scroll_width - 1);
+
+	// Newly exposed column
+	uint32_t column = (scroll_offset + scroll_width - 1) % length;
+	uint32_t symbolIdx = column / 8;
+	uint8_t value = scroll_invert ? 0xFF : 0x00;
+	if (symbolIdx < scroll_text.size())
+	{
+		value = GlyphAtlas::instance().getColumns(scroll_text[symbolIdx], scroll_invert)[column % 8];
+	}
+
+	data[scroll_width - 1] = value;
+
+	markDirty(scroll_line, scroll_line);
+
+	// Text start is visible again - hold it for a while
+	if (scroll_offset == 0)
+	{
+		scroll_timer = OSD_SCROLL_PAUSE;
+	}
+
+	result = true;
+
+	return result;
+}
+
 void OSD::printSymbol(uint8_t row, uint8_t column, char symbol, bool invert)
 {
 	uint8_t heightLimit = OSD_HIGHRES_HEIGHT_LINES;
@@ -190,16 +273,16 @@ void OSD::printSymbol(uint8_t row, uint8_t column, char symbol, bool invert)
 	if (row >= heightLimit || column >= widthLimit)
 		return;
 
-	// Print symbol by copying bytes from font array
-	uint8_t curOffset = column * 8;
-	for (uint8_t j = 0; j < 8; ++j)
-	{
-		uint8_t fontByte = charfont[(uint8_t)symbol][j];
-		if (invert)
-			fontByte = ~fontByte;
+	markDirty(row, row);
 
-		framebuffer[row][curOffset++] = fontByte;
-	}
+	// Print symbol by copying prepared columns from glyph atlas
+	memcpy(&framebuffer[row][column * 8], GlyphAtlas::instance().getColumns(symbol, invert), 8);
+}
+
+// Back buffer content (OSD_HIGHRES_HEIGHT_LINES lines by OSD_LINE_LENGTH_BYTES bytes)
+const uint8_t* OSD::getFramebuffer()
+{
+	return &framebuffer[0][0];
 }
 
 bool OSD::getPixel(const int x, const int y)
@@ -247,116 +330,86 @@ void OSD::setPixel(const int x, const int y, bool invert)
 	}
 
 	framebuffer[byteY][x] = value;
+	markDirty(byteY, byteY);
 }
 
 // Rectangular region operations
-void OSD::fillRect(uint8_t left, uint8_t top, uint8_t width, uint8_t height, bool clear)
-{
-	static int heightLimit = OSD_HIGHRES_HEIGHT_PX;
-	static int widthLimit = OSD_LINE_LENGTH_BYTES;
+// Framebuffer line holds 8 pixel rows, so each operation walks affected lines and processes columns
+// 4 bytes at a time with a per-line row mask (partial rows at top / bottom lines are preserved)
 
-	if (left >= widthLimit || top >= heightLimit)
-	{
-		LOGWARN("%s: left/top coordinates outside boundaries", __PRETTY_FUNCTION__);
+void OSD::fillRect(uint8_t left, uint8_t top, uint16_t width, uint8_t height, bool clear)
+{
+	int x = left, y = top, w = width, h = height;
+	if (!clipRect(x, y, w, h))
 		return;
-	}
 
-	for (int x = left; x < left + width && x < widthLimit; x++)
+	markDirtyPx(y, h);
+
+	for (int line = y / 8; line <= (y + h - 1) / 8; line++)
 	{
-		for (int y = top; y < top + height && y < heightLimit; y++)
+		uint8_t mask = getRowsMask(line, y, y + h);
+
+		if (!clear)
 		{
-			setPixel(x, y, clear);
+			rasterLine(&framebuffer[line][x], w, 0xFF, mask, 0x00);
+		}
+		else
+		{
+			rasterLine(&framebuffer[line][x], w, ~mask, 0x00, 0x00);
 		}
 	}
 }
 
-void OSD::fillRectOptimized(uint8_t left, uint8_t top, uint8_t width, uint8_t height, bool clear)
+void OSD::clearRect(uint8_t left, uint8_t top, uint16_t width, uint8_t height)
 {
-	static int heightLimit = OSD_HIGHRES_HEIGHT_PX;
-	static int widthLimit = OSD_LINE_LENGTH_BYTES;
+	fillRect(left, top, width, height, true);
+}
 
-	if (left >= widthLimit || top >= heightLimit)
-	{
-		LOGWARN("%s: left/top coordinates outside boundaries", __PRETTY_FUNCTION__);
+void OSD::invertRect(uint8_t left, uint8_t top, uint16_t width, uint8_t height)
+{
+	int x = left, y = top, w = width, h = height;
+	if (!clipRect(x, y, w, h))
 		return;
-	}
 
-	// Calculate if pixel lines are not aligned to byte boundary (8 vertical line pixels correspond to a byte in framebuffer)
-	uint8_t topOffset = top % 8;
-	uint8_t topByteY = top / 8;
-	uint8_t bottomOffset = (top + height) % 8;
-	uint8_t bottomByteY = (top + height) / 8;
-
-	// Calculate aligned rectangular where we can use byte operations for better speed
-	int alignedLines = height - topOffset - bottomOffset;
-	int alignedTop = -1;
-	int alignedHeight = -1;
-	if (alignedLines > 0 && alignedLines % 8 == 0)
+	markDirtyPx(y, h);
+
+	for (int line = y / 8; line <= (y + h - 1) / 8; line++)
 	{
-		alignedTop = top + topOffset;
-		alignedHeight = alignedLines;
+		rasterLine(&framebuffer[line][x], w, 0xFF, 0x00, getRowsMask(line, y, y + h));
 	}
+}
 
-	// Fill upper non-aligned rect
-	if (topOffset != 0)
-	{
-		// Create mask for upper <topOffset> bits
-		uint8_t topMask = (1 << topOffset) - 1;
-		uint8_t bottomMask = ~topMask;
+// Copy <bitmap> (framebuffer layout: <bitmapWidth> bytes per line, 8 pixel rows per line) to (<left>, <top>)
+// Any vertical position is supported, bitmap rows are shifted to match destination rows
+void OSD::blit(const uint8_t* bitmap, uint16_t bitmapWidth, uint8_t bitmapHeight, uint8_t left, uint8_t top)
+{
+	if (bitmap == nullptr)
+		return;
 
-		for (int x = left; x < left + width && x < widthLimit; x++)
-		{
-			uint8_t value = framebuffer[topByteY][x];
-			if (!clear)
-			{
-				value = (value & topMask) | (0xFF & bottomMask);
-			}
-			else
-			{
-				value = value & bottomMask;
-			}
-			framebuffer[topByteY][x] = value;
-		}
-	}
+	int x = left, y = top, w = bitmapWidth, h = bitmapHeight;
+	if (!clipRect(x, y, w, h))
+		return;
 
-	// Fill aligned rect
-	if (alignedTop >= 0 && alignedHeight > 0)
-	{
-		uint8_t fillByte = clear ? 0x00 : 0xFF;
+	markDirtyPx(y, h);
 
-		for (int x = left; x < left + width && x < widthLimit; x++)
-		{
-			for (int y = alignedTop / 8; y < (alignedTop + alignedHeight) / 8; y++)
-			{
-				framebuffer[y][x] = fillByte;
-			}
-		}
-	}
+	copyRect(bitmap, bitmapWidth, 0, 0, bitmapHeight, y, x, y, w, h);
+}
 
-	// Fill bottom non-aligned rect
-	if (bottomOffset != 0)
-	{
-		// Create mask for lower <bottomOffset> bits
-		uint8_t topMask = (1 << bottomOffset) - 1;
-		uint8_t bottomMask = ~topMask;
+// Move region content by <dy> pixel rows (positive - down). Rows uncovered by the move are cleared
+void OSD::scroll(uint8_t left, uint8_t top, uint16_t width, uint8_t height, int dy)
+{
+	int x = left, y = top, w = width, h = height;
+	if (!clipRect(x, y, w, h) || dy == 0)
+		return;
 
-		for (int x = left; x < left + width && x < widthLimit; x++)
-		{
-			uint8_t value = framebuffer[bottomByteY][x];
-			if (!clear)
-			{
-				value = (0xFF & topMask) | (value & bottomMask);
-			}
-			else
-			{
-				value = value & topMask;
-			}
-			framebuffer[bottomByteY][x] = value;
-		}
-	}
+	markDirtyPx(y, h);
+
+	copyRect(&framebuffer[0][0], OSD_LINE_LENGTH_BYTES, x, y, y + h, dy, x, y, w, h);
 }
 
-void OSD::invertRect(uint8_t left, uint8_t top, uint8_t width, uint8_t height)
+// Per-pixel reference implementations (slow, used to verify region operations)
+
+void OSD::fillRectReference(uint8_t left, uint8_t top, uint16_t width, uint8_t height, bool clear)
 {
 	static int heightLimit = OSD_HIGHRES_HEIGHT_PX;
 	static int widthLimit = OSD_LINE_LENGTH_BYTES;
@@ -367,18 +420,18 @@ void OSD::invertRect(uint8_t left, uint8_t top, uint8_t width, uint8_t height)
 		return;
 	}
 
+	markDirtyPx(top, height);
+
 	for (int x = left; x < left + width && x < widthLimit; x++)
 	{
 		for (int y = top; y < top + height && y < heightLimit; y++)
 		{
-			bool value = getPixel(x, y);
-			value = !value;
-			setPixel(x, y, !value);
+			setPixel(x, y, clear);
 		}
 	}
 }
 
-void OSD::invertRectOptimized(uint8_t left, uint8_t top, uint8_t width, uint8_t height)
+void OSD::invertRectReference(uint8_t left, uint8_t top, uint16_t width, uint8_t height)
 {
 	static int heightLimit = OSD_HIGHRES_HEIGHT_PX;
 	static int widthLimit = OSD_LINE_LENGTH_BYTES;
@@ -389,63 +442,62 @@ void OSD::invertRectOptimized(uint8_t left, uint8_t top, uint8_t width, uint8_t
 		return;
 	}
 
-	// Calculate if pixel lines are not aligned to byte boundary (8 vertical line pixels correspond to a byte in framebuffer)
-	uint8_t topOffset = top % 8;
-	uint8_t topByteY = top / 8;
-	uint8_t bottomOffset = (top + height) % 8;
-	uint8_t bottomByteY = (top + height) / 8;
-
-	// Calculate aligned rectangular where we can use byte operations for better speed
-	int alignedLines = height - topOffset - bottomOffset;
-	int alignedTop = -1;
-	int alignedHeight = -1;
-	if (alignedLines > 0 && alignedLines % 8 == 0)
-	{
-		alignedTop = top + topOffset;
-		alignedHeight = alignedLines;
-	}
+	markDirtyPx(top, height);
 
-	// Invert upper non-aligned rect
-	if (topOffset != 0)
+	for (int x = left; x < left + width && x < widthLimit; x++)
 	{
-		// Create mask for upper <topOffset> bits
-		uint8_t topMask = (1 << topOffset) - 1;
-		uint8_t bottomMask = ~topMask;
-
-		for (int x = left; x < left + width && x < widthLimit; x++)
+		for (int y = top; y < top + height && y < heightLimit; y++)
 		{
-			uint8_t value = framebuffer[topByteY][x];
-			value = (value & topMask) | (~value & bottomMask);
-			framebuffer[topByteY][x] = value;
+			bool value = getPixel(x, y);
+			value = !value;
+			setPixel(x, y, !value);
 		}
 	}
+}
 
-	// Invert aligned rect
-	if (alignedTop >= 0 && alignedHeight > 0)
+void OSD::blitReference(const uint8_t* bitmap, uint16_t bitmapWidth, uint8_t bitmapHeight, uint8_t left, uint8_t top)
+{
+	static int heightLimit = OSD_HIGHRES_HEIGHT_PX;
+	static int widthLimit = OSD_LINE_LENGTH_BYTES;
+
+	if (bitmap == nullptr || left >= widthLimit || top >= heightLimit)
+		return;
+
+	for (int x = 0; x < bitmapWidth && left + x < widthLimit; x++)
 	{
-		for (int x = left; x < left + width && x < widthLimit; x++)
+		for (int y = 0; y < bitmapHeight && top + y < heightLimit; y++)
 		{
-			for (int y = alignedTop / 8; y < (alignedTop + alignedHeight) / 8; y++)
-			{
-				uint8_t value = framebuffer[y][x];
-				value = ~value;
-				framebuffer[y][x] = value;
-			}
+			bool value = (bitmap[(y / 8) * bitmapWidth + x] >> (y % 8)) & 0x01;
+			setPixel(left + x, top + y, !value);
 		}
 	}
+}
+
+void OSD::scrollReference(uint8_t left, uint8_t top, uint16_t width, uint8_t height, int dy)
+{
+	static int heightLimit = OSD_HIGHRES_HEIGHT_PX;
+	static int widthLimit = OSD_LINE_LENGTH_BYTES;
+
+	if (left >= widthLimit || top >= heightLimit)
+		return;
 
-	// Invert bottom non-aligned rect
-	if (bottomOffset != 0)
+	int right = left + width < widthLimit ? left + width : widthLimit;
+	int bottom = top + height < heightLimit ? top + height : heightLimit;
+
+	for (int x = left; x < right; x++)
 	{
-		// Create mask for lower <bottomOffset> bits
-		uint8_t topMask = (1 << bottomOffset) - 1;
-		uint8_t bottomMask = ~topMask;
+		// Snapshot the column first, since source and destination overlap
+		bool column[OSD_HIGHRES_HEIGHT_PX];
+		for (int y = top; y < bottom; y++)
+		{
+			column[y] = getPixel(x, y);
+		}
 
-		for (int x = left; x < left + width && x < widthLimit; x++)
+		for (int y = top; y < bottom; y++)
 		{
-			uint8_t value = framebuffer[bottomByteY][x];
-			value = (~value & topMask) | (value & bottomMask);
-			framebuffer[bottomByteY][x] = value;
+			int source = y - dy;
+			bool value = source >= top && source < bottom && column[source];
+			setPixel(x, y, !value);
 		}
 	}
 }
@@ -454,103 +506,205 @@ void OSD::invertRectOptimized(uint8_t left, uint8_t top, uint8_t width, uint8_t
 void OSD::clearFramebuffer()
 {
 	memset(framebuffer, 0, sizeof(framebuffer));
+	markDirty(0, OSD_HIGHRES_HEIGHT_LINES - 1);
 }
 
-void OSD::rotateCharacter(uint8_t *in, uint8_t *out)
+void OSD::markDirty(int fromLine, int toLine)
 {
-	uint8_t value;
+	fromLine = fromLine < 0 ? 0 : fromLine;
+	toLine = toLine >= OSD_HIGHRES_HEIGHT_LINES ? OSD_HIGHRES_HEIGHT_LINES - 1 : toLine;
 
-	for (int i = 0; i < 8; i++)
+	for (int line = fromLine; line <= toLine; line++)
 	{
-		value = 0;
-		for (int j = 0; j < 8; j++)
-		{
-			value <<= 1;
-			value |= (*(in + j) >> i) & 1;
-		}
+		dirtyLines |= 1 << line;
+	}
+}
 
-		*(out + i) = value;
+// Pixel rows => framebuffer lines (each line holds 8 pixel rows)
+void OSD::markDirtyPx(int top, int height)
+{
+	if (height > 0)
+	{
+		markDirty(top / 8, (top + height - 1) / 8);
 	}
 }
 
-uint8_t OSD::scale4Bits(uint8_t byte)
+// Clip rect to framebuffer. Returns false if there is nothing to process
+bool OSD::clipRect(int& left, int& top, int& width, int& height)
 {
-	uint8_t result = 0;
-	uint8_t mask = 0b00000001;
+	bool result = false;
 
-	uint8_t value = 0;
-	for (int i = 0; i < 4; i++)
+	if (left >= OSD_LINE_LENGTH_BYTES || top >= OSD_HIGHRES_HEIGHT_PX)
 	{
-		value = byte << i;
+		LOGWARN("%s: left/top coordinates outside boundaries", __PRETTY_FUNCTION__);
+		return result;
+	}
 
-		result = (result & ~mask) | (value & mask);
-		value <<= 1;
-		mask <<= 1;
-		result = (result & ~mask) | (value & mask);
+	width = left + width > OSD_LINE_LENGTH_BYTES ? OSD_LINE_LENGTH_BYTES - left : width;
+	height = top + height > OSD_HIGHRES_HEIGHT_PX ? OSD_HIGHRES_HEIGHT_PX - top : height;
 
-		mask <<= 1;
+	result = width > 0 && height > 0;
+
+	return result;
+}
+
+// Bit mask of pixel rows [<from>, <to>) within framebuffer <line> (LSB - top row). 0 if line is not covered
+uint8_t OSD::getRowsMask(int line, int from, int to)
+{
+	uint8_t result = 0;
+
+	int low = from - line * 8;
+	int high = to - line * 8;
+	low = low < 0 ? 0 : low;
+	high = high > 8 ? 8 : high;
+
+	if (high > low)
+	{
+		result = ((1 << high) - 1) & ~((1 << low) - 1);
 	}
 
 	return result;
 }
 
-uint16_t OSD::scale8Bits(uint8_t byte)
+// value = ((value & andMask) | orMask) ^ xorMask for <width> bytes starting from <data>
+// Unaligned head / tail are processed byte by byte, the rest - with 32-bit words
+void OSD::rasterLine(uint8_t* data, int width, uint8_t andMask, uint8_t orMask, uint8_t xorMask)
 {
-	uint16_t result = 0;
-	uint16_t mask = 0b0000000000000001;
+	uint8_t* end = data + width;
 
-	uint16_t expanded = byte;
-	uint16_t value = 0;
-	for (int i = 0; i < 8; i++)
+	while (data < end && ((uintptr_t)data & 0x03) != 0)
 	{
-		value = expanded << i;
+		*data = ((*data & andMask) | orMask) ^ xorMask;
+		data++;
+	}
 
-		result = (result & ~mask) | (value & mask);
-		value <<= 1;
-		mask <<= 1;
-		result = (result & ~mask) | (value & mask);
+	uint32_t andWord = replicate(andMask);
+	uint32_t orWord = replicate(orMask);
+	uint32_t xorWord = replicate(xorMask);
 
-		mask <<= 1;
+	for (; data + 4 <= end; data += 4)
+	{
+		store32(data, ((load32(data) & andWord) | orWord) ^ xorWord);
 	}
 
-	return result;
+	for (; data < end; data++)
+	{
+		*data = ((*data & andMask) | orMask) ^ xorMask;
+	}
 }
 
 /*
- * Transfer the whole OSD framebuffer (4096 bytes) to the FPGA side
- * Usually takes ~6.1ms to accomplish
- * Not VBlank synchronized, so don't try to make heavy animations
+ * Copy <width> x <height> region to (<left>, <top>). Destination row y receives source row (y - <shift>),
+ * source rows outside [<sourceTop>, <sourceBottom>) are read as empty. Source is in framebuffer layout
+ * (<stride> bytes per line), columns are taken from <sourceLeft>.
+ * Source and destination may overlap (scroll): lines are processed in the direction of the move, and each
+ * destination word is stored only after both source words for it were loaded
  */
-void OSD::transferFramebuffer()
+void OSD::copyRect(const uint8_t* source, uint16_t stride, int sourceLeft, int sourceTop, int sourceBottom, int shift,
+		int left, int top, int width, int height)
 {
-	FPGADevice& fpga = FPGADevice::instance();
-	FPGAConnector& connector = *(fpga.connector);
-	FPGACommand& command = *(fpga.command);
+	static const uint8_t emptyLine[OSD_LINE_LENGTH_BYTES] = { 0 };
+
+	// Split row shift into whole lines and remaining bits (floor division, shift can be negative)
+	int lineShift = shift >= 0 ? shift / 8 : -((7 - shift) / 8);
+	int bitShift = shift - lineShift * 8;
 
-	if (command.startOSD())
+	int firstLine = top / 8;
+	int lastLine = (top + height - 1) / 8;
+	int lines = lastLine - firstLine + 1;
+
+	for (int idx = 0; idx < lines; idx++)
 	{
-		TRACE("OSD buffer transfer started");
+		int line = shift > 0 ? lastLine - idx : firstLine + idx;
+		uint8_t mask = getRowsMask(line, top, top + height);
+
+		// Destination line bits come from <upper> source line (shifted down by bitShift) and the bottom rows of the line above it
+		int upper = line - lineShift;
+		int lower = upper - 1;
+		uint8_t upperMask = getRowsMask(upper, sourceTop, sourceBottom);
+		uint8_t lowerMask = bitShift != 0 ? getRowsMask(lower, sourceTop, sourceBottom) : 0;
+
+		const uint8_t* upperData = upperMask != 0 ? source + upper * stride + sourceLeft : emptyLine;
+		const uint8_t* lowerData = lowerMask != 0 ? source + lower * stride + sourceLeft : emptyLine;
+
+		uint8_t upperBits = (0xFF << bitShift) & 0xFF;
+		uint8_t lowerBits = ~upperBits;
 
-		// Write to buffer command (Line is selected as render start MM1_OSDCMDWRITE | 0)
-		command.sendCommand(MM1_OSDCMDWRITE);
+		uint32_t maskWord = replicate(mask);
+		uint32_t upperMaskWord = replicate(upperMask);
+		uint32_t lowerMaskWord = replicate(lowerMask);
+		uint32_t upperBitsWord = replicate(upperBits);
+		uint32_t lowerBitsWord = replicate(lowerBits);
 
-		// Transfer changes to FPGA framefuffer (byte size transfers)
-		uint8_t *pBuffer = &framebuffer[0][0];
-		for (unsigned idx = 0; idx < sizeof(framebuffer); idx++)
+		uint8_t* data = &framebuffer[line][left];
+		int x = 0;
+
+		// Unaligned destination head
+		for (; x < width && ((uintptr_t)(data + x) & 0x03) != 0; x++)
 		{
-			//unsigned j = idx % OSD_LINE_LENGTH_BYTES;
-			//unsigned i = idx / OSD_LINE_LENGTH_BYTES;
-			//connector.transferByte(framebuffer[i][j]);
+			uint8_t value = (uint8_t)((upperData[x] & upperMask) << bitShift);
+			if (bitShift != 0)
+			{
+				value |= (lowerData[x] & lowerMask) >> (8 - bitShift);
+			}
 
-			connector.transferByte(*(pBuffer++));
+			data[x] = (data[x] & ~mask) | (value & mask);
 		}
 
-		command.endOSD();
+		// Aligned 32-bit words (bytes are shifted independently, carries between bytes are masked out)
+		for (; x + 4 <= width; x += 4)
+		{
+			uint32_t value = ((load32(upperData + x) & upperMaskWord) << bitShift) & upperBitsWord;
+			if (bitShift != 0)
+			{
+				value |= ((load32(lowerData + x) & lowerMaskWord) >> (8 - bitShift)) & lowerBitsWord;
+			}
+
+			store32(data + x, (load32(data + x) & ~maskWord) | (value & maskWord));
+		}
 
-		TRACE("OSD buffer transfer finished");
+		// Tail
+		for (; x < width; x++)
+		{
+			uint8_t value = (uint8_t)((upperData[x] & upperMask) << bitShift);
+			if (bitShift != 0)
+			{
+				value |= (lowerData[x] & lowerMask) >> (8 - bitShift);
+			}
+
+			data[x] = (data[x] & ~mask) | (value & mask);
+		}
 	}
-	else
+}
+
+uint8_t OSD::scale4Bits(uint8_t byte)
+{
+	uint8_t result = 0;
+	uint8_t mask = 0b00000001;
+
+	uint8_t value = 0;
+	for (int i = 0; i < 4; i++)
 	{
-		LOGWARN("%s: Unable to start FPGA command to transfer OSD buffer", __PRETTY_FUNCTION__);
+		value = byte << i;
+
+		result = (result & ~mask) | (value & mask);
+		value <<= 1;
+		mask <<= 1;
+		result = (result & ~mask) | (value & mask);
+
+		mask <<= 1;
 	}
+
+	return result;
+}
+
+/*
+ * Pass back buffer to presenter. Transfer to FPGA happens asynchronously (only changed lines are sent),
+ * so caller (input event handler) is not blocked by OSD bus transfer
+ */
+void OSD::commitFramebuffer()
+{
+	OSDPresenter::instance().commit(&framebuffer[0][0], dirtyLines);
+
+	dirtyLines = 0;
 }
@@ -1,6 +1,7 @@
 #ifndef GUI_OSD_OSD_H_
 #define GUI_OSD_OSD_H_
 
+#include <atomic>
 #include <string>
 #include <stdint.h>
 
@@ -67,6 +68,15 @@ using namespace std;
 #define OSD_ENABLE		((uint8_t)0x01)
 #define OSD_DISABLE		((uint8_t)0x00)
 
+// Unknown - state left by the core / previous run, so the first show or hide is always sent
+enum class OSDVisibility: uint8_t
+{
+	Unknown = 0,
+	Hidden,
+	Shown,
+	ShownHighres
+};
+
 class OSD
 {
 public:
@@ -84,14 +94,27 @@ public:
 	static const uint16_t OSD_LINE_LENGTH = OSD_LINE_LENGTH_BYTES / 8;
 
 protected:
-	// Fields
+	// Fields (framebuffer is a back buffer: drawing never touches FPGA, compose() commits it to OSDPresenter)
 	uint8_t titlebuffer[2][OSD_HIGHRES_HEIGHT_LINES * 8]; // Horizontal buffer for initial title rendering. After rotation - 16 symbols height in highres and 8 in lowres
 	uint8_t framebuffer[OSD_HIGHRES_HEIGHT_LINES][OSD_LINE_LENGTH_BYTES];
 
+	// Lines modified since last commit (bit per framebuffer line)
+	uint16_t dirtyLines = 0;
+
 	bool arrowDirection;
 
-	uint32_t scroll_offset = 0; // file/dir name scrolling position
-	uint32_t scroll_timer = 0;  // file/dir name scrolling timer
+	// OSD state on FPGA side (show/hide are called after each menu event, commands are sent on state change only)
+	OSDVisibility visibility = OSDVisibility::Unknown;
+
+	// Marquee scrolling of long file/dir name (single line, shifted one pixel column per step)
+	atomic<bool> scroll_active { false };	// Checked by menu tick timer (timer service thread)
+	uint8_t scroll_line = 0;
+	uint16_t scroll_left = 0;	// Scrolling area (in px)
+	uint16_t scroll_width = 0;
+	string scroll_text;
+	bool scroll_invert = false;
+	uint32_t scroll_offset = 0; // file/dir name scrolling position (in px)
+	uint32_t scroll_timer = 0;  // file/dir name scrolling timer (steps to wait before scrolling starts / continues)
 
 public:
 	static OSD& instance();
@@ -107,27 +130,47 @@ public:
 	void fill();
 	void clear();
 	void compose();
+	void invalidate();
 	void setTitle(const string& title, uint8_t arrows = 0);
 	void printLine(uint8_t line, const string& text, bool invert = false);
 
+	// Marquee scrolling for text not fitting into its area
+	void startTextScroll(uint8_t line, uint16_t left, uint16_t width, const string& text, bool invert = false);
+	void stopTextScroll();
+	bool scrollTextStep();
+	bool isTextScrolling();
+
 	void printSymbol(uint8_t row, uint8_t column, char symbol, bool invert = false);
 	bool getPixel(const int x, const int y);
 	void setPixel(const int x, const int y, bool invert = false);
 
-	// Rectangular region operations
-	void fillRect(uint8_t left, uint8_t top, uint8_t width, uint8_t height, bool clear = false);
-	void invertRect(uint8_t left, uint8_t top, uint8_t width, uint8_t height);
+	const uint8_t* getFramebuffer();
+
+	// Rectangular region operations (any pixel alignment, processed with 32-bit words)
+	void fillRect(uint8_t left, uint8_t top, uint16_t width, uint8_t height, bool clear = false);
+	void clearRect(uint8_t left, uint8_t top, uint16_t width, uint8_t height);
+	void invertRect(uint8_t left, uint8_t top, uint16_t width, uint8_t height);
+	void blit(const uint8_t* bitmap, uint16_t bitmapWidth, uint8_t bitmapHeight, uint8_t left, uint8_t top);
+	void scroll(uint8_t left, uint8_t top, uint16_t width, uint8_t height, int dy);
 
-	void fillRectOptimized(uint8_t left, uint8_t top, uint8_t width, uint8_t height, bool clear = false);
-	void invertRectOptimized(uint8_t left, uint8_t top, uint8_t width, uint8_t height);
+	// Per-pixel reference implementations (slow, used to verify region operations)
+	void fillRectReference(uint8_t left, uint8_t top, uint16_t width, uint8_t height, bool clear = false);
+	void invertRectReference(uint8_t left, uint8_t top, uint16_t width, uint8_t height);
+	void blitReference(const uint8_t* bitmap, uint16_t bitmapWidth, uint8_t bitmapHeight, uint8_t left, uint8_t top);
+	void scrollReference(uint8_t left, uint8_t top, uint16_t width, uint8_t height, int dy);
 
 protected:
 	// Helper methods
 	void clearFramebuffer();
-	void rotateCharacter(uint8_t *in, uint8_t *out);
+	void markDirty(int fromLine, int toLine);
+	void markDirtyPx(int top, int height);
+	bool clipRect(int& left, int& top, int& width, int& height);
+	uint8_t getRowsMask(int line, int from, int to);
+	void rasterLine(uint8_t* data, int width, uint8_t andMask, uint8_t orMask, uint8_t xorMask);
+	void copyRect(const uint8_t* source, uint16_t stride, int sourceLeft, int sourceTop, int sourceBottom, int shift,
+			int left, int top, int width, int height);
 	uint8_t scale4Bits(uint8_t byte);
-	uint16_t scale8Bits(uint8_t byte);
-	void transferFramebuffer();
+	void commitFramebuffer();
 
 private:
 	OSD() {}; // Prevent creation. Only singleton via instance() should be accessible
@@ -0,0 +1,459 @@
+#include "osdpresenter.h"
+
+#include "../../common/logger/logger.h"
+
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include "../../common/diagnostics/latencytracer.h"
+#include "../../common/timer/timerservice.h"
+
+OSDPresenter& OSDPresenter::instance()
+{
+	static OSDPresenter instance;
+
+	return instance;
+}
+
+OSDPresenter::~OSDPresenter()
+{
+	dispose();
+}
+
+void OSDPresenter::dispose()
+{
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexFrame);
+
+		m_stop = true;
+	}
+
+	// Wake up the thread, so it can notice stop request
+	m_frameCommitted.notify_all();
+
+	stop();
+}
+
+// Make back buffer content the frame to be presented. Previous frame is dropped if it wasn't transferred yet
+// (its dirty lines are carried over). If presenter thread is not running - frame is transferred synchronously
+void OSDPresenter::commit(const uint8_t* framebuffer, uint16_t dirtyLines)
+{
+	if (framebuffer == nullptr)
+		return;
+
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexFrame);
+
+		if (m_isPending)
+		{
+			m_framesDropped++;
+		}
+
+		memcpy(m_frame, framebuffer, sizeof(m_frame));
+		m_frameDirty |= dirtyLines;
+		m_frameTimestamp = LatencyTracer::now();
+		m_frameId++;
+		m_isPending = true;
+
+		// Dropped frame could be a response to earlier input - the oldest one is kept
+		if (m_frameTraceName.empty() && !m_traceName.empty())
+		{
+			m_frameTraceName = m_traceName;
+			m_frameTraceTimestamp = m_traceTimestamp;
+		}
+	}
+
+	m_framesCommitted++;
+
+	if (m_stopped)
+	{
+		present();
+	}
+	else
+	{
+		m_frameCommitted.notify_one();
+	}
+}
+
+// FPGA side content is not known anymore (e.g. OSD was used by the core), so next present is a full one
+void OSDPresenter::invalidate()
+{
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexFrame);
+
+	m_isInvalidated = true;
+	m_frameId++;
+}
+
+// Show / hide OSD once pending frame (if any) is transferred. If presenter thread is not running - it's done synchronously
+void OSDPresenter::setVisibility(OSDVisibility visibility)
+{
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexFrame);
+
+		m_visibility = visibility;
+		m_isVisibilityPending = true;
+	}
+
+	if (m_stopped)
+	{
+		present();
+	}
+	else
+	{
+		m_frameCommitted.notify_one();
+	}
+}
+
+// Frames committed till the next call are traced as a response to input event <name> (Transfer stage is recorded
+// when such frame reaches render targets). Empty <name> stops tracing
+void OSDPresenter::traceInput(const string& name, uint64_t timestamp)
+{
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexFrame);
+
+	m_traceName = name;
+	m_traceTimestamp = timestamp;
+}
+
+// Transfer pending changes (waits up to OSD_SUSPEND_TIMEOUT) and stop presentation till resume().
+// Used while FPGA is reconfigured: nothing should drive FPGA bus then, and OSD disable has to reach the old core first
+void OSDPresenter::suspend()
+{
+	if (m_stopped)
+	{
+		present();
+	}
+
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		unique_lock<mutex> lock(m_mutexFrame);
+
+		bool isFlushed = m_framePresented.wait_for(lock, chrono::milliseconds(OSD_SUSPEND_TIMEOUT),
+			[this]() { return (!m_isPending && !m_isVisibilityPending) || m_stopped; });
+
+		if (!isFlushed)
+		{
+			LOGWARN("%s: pending OSD changes were not transferred in %d ms", __PRETTY_FUNCTION__, OSD_SUSPEND_TIMEOUT);
+		}
+
+		m_isSuspended = true;
+	}
+
+	// Wait till in-flight present is finished (the next one will see suspended state)
+	lock_guard<mutex> lockPresent(m_mutexPresent);
+}
+
+// Presentation is allowed again. Changes made while suspended are transferred
+void OSDPresenter::resume()
+{
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexFrame);
+
+		m_isSuspended = false;
+	}
+
+	if (m_stopped)
+	{
+		present();
+	}
+	else
+	{
+		m_frameCommitted.notify_one();
+	}
+}
+
+IOSDRenderTarget* OSDPresenter::getFPGATarget()
+{
+	return &m_fpgaTarget;
+}
+
+// New target has no content yet, so next present is a full one
+void OSDPresenter::addTarget(IOSDRenderTarget* target)
+{
+	if (target == nullptr)
+		return;
+
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexPresent);
+
+		if (find(m_targets.begin(), m_targets.end(), target) != m_targets.end())
+			return;
+
+		m_targets.push_back(target);
+	}
+
+	LOGINFO("OSD render target '%s' added", target->getName());
+
+	invalidate();
+}
+
+// Target is not used anymore once the method returns (in-flight present is finished before)
+void OSDPresenter::removeTarget(IOSDRenderTarget* target)
+{
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexPresent);
+
+	auto it = find(m_targets.begin(), m_targets.end(), target);
+	if (it != m_targets.end())
+	{
+		m_targets.erase(it);
+
+		LOGINFO("OSD render target '%s' removed", target->getName());
+	}
+}
+
+// Limit presentation rate to one frame per OSD_PRESENT_INTERVAL. Intermediate frames are dropped
+void OSDPresenter::setPacing(bool isPaced)
+{
+	m_isPaced = isPaced;
+}
+
+OSDPresenterStatistics OSDPresenter::getStatistics()
+{
+	OSDPresenterStatistics result;
+
+	result.committed = m_framesCommitted;
+	result.presented = m_framesPresented;
+	result.dropped = m_framesDropped;
+	result.presentTime = m_presentTime;
+	result.lastPresentTime = m_lastPresentTime;
+
+	return result;
+}
+
+// Helper methods
+
+// Present pending frame and visibility change (if any). Returns false if any target was busy and changes are still pending
+bool OSDPresenter::present()
+{
+	bool result = true;
+
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lockPresent(m_mutexPresent);
+
+	bool isPending = false;
+	uint16_t dirty = 0;
+	uint64_t timestamp = 0;
+	uint32_t frameId = 0;
+	bool isInvalidated = false;
+	string traceName;
+	uint64_t traceTimestamp = 0;
+	OSDVisibility visibility = OSDVisibility::Unknown;
+	bool isVisibilityPending = false;
+
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexFrame);
+
+		// Everything stays pending till resume
+		if (m_isSuspended)
+			return result;
+
+		isPending = m_isPending;
+		if (isPending)
+		{
+			memcpy(m_presentbuffer, m_frame, sizeof(m_presentbuffer));
+			dirty = m_frameDirty;
+			timestamp = m_frameTimestamp;
+			frameId = m_frameId;
+			isInvalidated = m_isInvalidated;
+			traceName.swap(m_frameTraceName);
+			traceTimestamp = m_frameTraceTimestamp;
+
+			m_frameDirty = 0;
+			m_isInvalidated = false;
+			m_isPending = false;
+		}
+
+		visibility = m_visibility;
+		isVisibilityPending = m_isVisibilityPending;
+		m_isVisibilityPending = false;
+	}
+
+	bool isFramePresented = true;
+
+	if (isPending)
+	{
+		if (isInvalidated)
+		{
+			m_isSentValid = false;
+		}
+
+		// Redrawn lines are often identical to what targets already show - compare with the shadow copy
+		uint16_t lines = 0;
+
+		for (uint8_t line = 0; line < LINES; line++)
+		{
+			bool isChanged = !m_isSentValid ||
+				((dirty & (1 << line)) && memcmp(m_presentbuffer[line], m_sentbuffer[line], LINE_BYTES) != 0);
+
+			if (isChanged)
+			{
+				lines |= 1 << line;
+			}
+		}
+
+		if (lines != 0)
+		{
+			isFramePresented = presentLines(lines, frameId, timestamp, traceName, traceTimestamp);
+		}
+
+		if (isFramePresented)
+		{
+			m_framesPresented++;
+			m_lastPresent = TimerService::now();
+		}
+	}
+
+	result = isFramePresented;
+
+	// OSD is shown only after the frame is transferred, so it never shows outdated content
+	if (result && isVisibilityPending)
+	{
+		result = presentVisibility(visibility);
+	}
+
+	if (!result)
+	{
+		// Target is busy - changes stay pending (unless superseded already) for the next attempt
+		lock_guard<mutex> lock(m_mutexFrame);
+
+		if (isPending && !isFramePresented)
+		{
+			m_frameDirty |= dirty;
+			m_isInvalidated = m_isInvalidated || isInvalidated;
+			m_isPending = true;
+
+			if (m_frameTraceName.empty())
+			{
+				m_frameTraceName.swap(traceName);
+				m_frameTraceTimestamp = traceTimestamp;
+			}
+		}
+
+		m_isVisibilityPending = m_isVisibilityPending || isVisibilityPending;
+	}
+
+	return result;
+}
+
+// Send changed lines to render targets that don't have frame <frameId> yet. Time spent is collected separately from drawing time.
+// Returns false if some target was busy (frame stays pending for that target only)
+bool OSDPresenter::presentLines(uint16_t lines, uint32_t frameId, uint64_t timestamp, const string& traceName, uint64_t traceTimestamp)
+{
+	bool result = true;
+
+	if (frameId != m_presentedFrameId)
+	{
+		m_presentedTargets.clear();
+		m_presentedFrameId = frameId;
+	}
+
+	uint64_t started = LatencyTracer::now();
+
+	for (IOSDRenderTarget* target : m_targets)
+	{
+		if (find(m_presentedTargets.begin(), m_presentedTargets.end(), target) != m_presentedTargets.end())
+			continue;
+
+		if (target->present(&m_presentbuffer[0][0], LINES, LINE_BYTES, lines, timestamp))
+		{
+			m_presentedTargets.push_back(target);
+		}
+		else
+		{
+			result = false;
+		}
+	}
+
+	uint32_t elapsed = (uint32_t)(LatencyTracer::now() - started);
+	m_presentTime += elapsed;
+	m_lastPresentTime = elapsed;
+
+	if (result)
+	{
+		// Targets now match presented lines
+		for (uint8_t line = 0; line < LINES; line++)
+		{
+			if (lines & (1 << line))
+			{
+				memcpy(m_sentbuffer[line], m_presentbuffer[line], LINE_BYTES);
+			}
+		}
+
+		m_isSentValid = m_isSentValid || lines == ALL_LINES;
+
+		// Input event response reached the screen
+		if (!traceName.empty())
+		{
+			LatencyTracer::instance().record(traceName, LatencyStageEnum::Transfer, traceTimestamp);
+		}
+	}
+
+	return result;
+}
+
+// Only FPGA OSD has visibility state (if FPGA target is not used - there is nothing to show or hide)
+bool OSDPresenter::presentVisibility(OSDVisibility visibility)
+{
+	bool result = true;
+
+	if (find(m_targets.begin(), m_targets.end(), &m_fpgaTarget) != m_targets.end())
+	{
+		result = m_fpgaTarget.setVisibility(visibility);
+	}
+
+	return result;
+}
+
+// Runnable override method(s)
+
+// Async thread body
+void OSDPresenter::run()
+{
+	LOGINFO("OSDPresenter: thread started with tid: %d (0x%x)", m_thread_id, m_thread_id);
+
+	while (!m_stop)
+	{
+		{
+			// Lock parallel threads to access (active till the end of the block)
+			unique_lock<mutex> lock(m_mutexFrame);
+
+			m_frameCommitted.wait(lock, [this]() { return ((m_isPending || m_isVisibilityPending) && !m_isSuspended) || m_stop; });
+		}
+
+		if (m_stop)
+			break;
+
+		// Paced mode: wait till the next frame slot, commits arrived meanwhile supersede pending frame
+		if (m_isPaced)
+		{
+			uint64_t next = m_lastPresent + OSD_PRESENT_INTERVAL;
+			uint64_t now = TimerService::now();
+			if (now < next)
+			{
+				usleep((next - now) * 1000);
+			}
+		}
+
+		bool isPresented = present();
+
+		// Wake up suspend() waiting for pending changes
+		m_framePresented.notify_all();
+
+		// Target is busy (e.g. FPGA with other command) - retry shortly
+		if (!isPresented)
+		{
+			usleep(1000);
+		}
+	}
+
+	LOGINFO("OSDPresenter: thread with tid: %d (0x%x) loop stopped", m_thread_id, m_thread_id);
+}
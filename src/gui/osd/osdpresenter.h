@@ -0,0 +1,127 @@
+#ifndef GUI_OSD_OSDPRESENTER_H_
+#define GUI_OSD_OSDPRESENTER_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../../common/consts.h"
+#include "../../common/thread/runnable.h"
+#include "../../interfaces/iosdrendertarget.h"
+#include "osd.h"
+#include "fpgarendertarget.h"
+
+using namespace std;
+
+struct OSDPresenterStatistics
+{
+	uint32_t committed = 0;		// Frames committed by renderer
+	uint32_t presented = 0;		// Frames transferred to FPGA
+	uint32_t dropped = 0;		// Frames superseded by newer commit before being transferred
+	uint64_t presentTime = 0;	// Total time spent in render targets (us), i.e. transfer cost without drawing
+	uint32_t lastPresentTime = 0;	// Time spent in render targets by the latest presented frame (us)
+};
+typedef struct OSDPresenterStatistics OSDPresenterStatistics;
+
+// Front side of double-buffered OSD.
+// Renderer draws into OSD framebuffer (back buffer) and commits it here. Presenter thread pushes
+// the latest committed frame to render targets (FPGA by default), so input handling never waits for the OSD bus transfer.
+// Only changed lines are reported to targets (compared with shadow copy of already presented content)
+class OSDPresenter : public Runnable
+{
+protected:
+	static const uint8_t LINES = OSD::OSD_HIGHRES_HEIGHT_LINES;
+	static const uint16_t LINE_BYTES = OSD::OSD_LINE_LENGTH_BYTES;
+	static const uint16_t ALL_LINES = (1 << LINES) - 1;
+
+	// Latest committed frame (replaced by each commit)
+	mutex m_mutexFrame;
+	condition_variable m_frameCommitted;
+	condition_variable m_framePresented;
+	uint8_t m_frame[LINES][LINE_BYTES];
+	uint16_t m_frameDirty = 0;
+	uint64_t m_frameTimestamp = 0;		// Commit time of the latest frame (us)
+	uint32_t m_frameId = 0;				// Changed by each commit / invalidate
+	bool m_isPending = false;
+	bool m_isInvalidated = true;		// FPGA side content is unknown, next present sends everything
+
+	// Latency tracing: input event being handled and the one that caused pending frame (empty name - none)
+	string m_traceName;
+	uint64_t m_traceTimestamp = 0;
+	string m_frameTraceName;
+	uint64_t m_frameTraceTimestamp = 0;
+
+	// Requested OSD visibility. Applied after pending frame is transferred (in order with frames)
+	OSDVisibility m_visibility = OSDVisibility::Unknown;
+	bool m_isVisibilityPending = false;
+
+	// FPGA is being reconfigured - nothing is transferred, changes are kept pending till resume
+	bool m_isSuspended = false;
+
+	// Presentation state (guarded by m_mutexPresent: presenter thread or committer if thread isn't running)
+	mutex m_mutexPresent;
+	uint8_t m_presentbuffer[LINES][LINE_BYTES];
+	uint8_t m_sentbuffer[LINES][LINE_BYTES];
+	bool m_isSentValid = false;
+	uint64_t m_lastPresent = 0;
+
+	// Render targets (guarded by m_mutexPresent)
+	FPGARenderTarget m_fpgaTarget;
+	vector<IOSDRenderTarget*> m_targets { &m_fpgaTarget };
+
+	// Targets that already got frame m_presentedFrameId. If some target was busy, only the rest of them get the retry
+	uint32_t m_presentedFrameId = 0;
+	vector<IOSDRenderTarget*> m_presentedTargets;
+
+	atomic<bool> m_isPaced;
+
+	atomic<uint32_t> m_framesCommitted { 0 };
+	atomic<uint32_t> m_framesPresented { 0 };
+	atomic<uint32_t> m_framesDropped { 0 };
+	atomic<uint64_t> m_presentTime { 0 };
+	atomic<uint32_t> m_lastPresentTime { 0 };
+
+public:
+	// Singleton instance
+	static OSDPresenter& instance();
+	OSDPresenter(OSDPresenter&&) = delete;						// Disable move constructor (C++11 feature)
+	OSDPresenter(const OSDPresenter& that) = delete; 			// Disable copy constructor (C++11 feature)
+	OSDPresenter& operator =(OSDPresenter const&) = delete;		// Disable assignment operator (C++11 feature)
+	virtual ~OSDPresenter();
+
+public:
+	void dispose();
+
+	void commit(const uint8_t* framebuffer, uint16_t dirtyLines);
+	void invalidate();
+	void setVisibility(OSDVisibility visibility);
+	void traceInput(const string& name, uint64_t timestamp);
+
+	void suspend();
+	void resume();
+
+	IOSDRenderTarget* getFPGATarget();
+	void addTarget(IOSDRenderTarget* target);
+	void removeTarget(IOSDRenderTarget* target);
+
+	void setPacing(bool isPaced);
+	OSDPresenterStatistics getStatistics();
+
+// Helper methods
+protected:
+	bool present();
+	bool presentLines(uint16_t lines, uint32_t frameId, uint64_t timestamp, const string& traceName, uint64_t traceTimestamp);
+	bool presentVisibility(OSDVisibility visibility);
+
+// Runnable override method(s)
+protected:
+	// Async thread body
+	void run();
+
+private:
+	OSDPresenter() : Runnable("osd_present"), m_isPaced(false) {};	// Disable explicit object creation (only singleton instance allowed)
+};
+
+#endif /* GUI_OSD_OSDPRESENTER_H_ */
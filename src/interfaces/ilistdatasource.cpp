@@ -0,0 +1,9 @@
+#include "ilistdatasource.h"
+
+IListDataSource::IListDataSource()
+{
+}
+
+IListDataSource::~IListDataSource()
+{
+}
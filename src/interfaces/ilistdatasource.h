@@ -0,0 +1,41 @@
+#ifndef INTERFACES_ILISTDATASOURCE_H_
+#define INTERFACES_ILISTDATASOURCE_H_
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct ListItem
+{
+	// Item name to display
+	string name;
+
+	// Associated value
+	int value;
+
+	// Enabled / disabled flag (Disabled items cannot be selected and grayed-out visually)
+	bool disabled = false;
+
+	ListItem() {};
+	ListItem(const string& name, int value, bool disabled): name(name), value(value), disabled(disabled) {};
+};
+typedef struct ListItem ListItem;
+typedef vector<ListItem> ListItemVector;
+
+// Virtual data source for list controls. Items are fetched on demand by index,
+// so controls never need a copy of the whole collection (folders may contain tens of thousands of entries)
+class IListDataSource
+{
+public:
+	IListDataSource();
+	IListDataSource(const IListDataSource& that) = delete; // Copy constructor is forbidden here (C++11 feature)
+	virtual ~IListDataSource();
+
+	virtual int getItemCount() = 0;
+
+	// Fill <item> with data for <index> (0..getItemCount() - 1). Returns false if index is not valid anymore
+	virtual bool getItem(int index, ListItem& item) = 0;
+};
+
+#endif /* INTERFACES_ILISTDATASOURCE_H_ */
@@ -0,0 +1,9 @@
+#include "iosdrendertarget.h"
+
+IOSDRenderTarget::IOSDRenderTarget()
+{
+}
+
+IOSDRenderTarget::~IOSDRenderTarget()
+{
+}
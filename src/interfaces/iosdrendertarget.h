@@ -0,0 +1,22 @@
+#ifndef INTERFACES_IOSDRENDERTARGET_H_
+#define INTERFACES_IOSDRENDERTARGET_H_
+
+#include <stdint.h>
+
+// Destination for composed OSD frames (FPGA, image files for headless runs etc.)
+// Frame has OSD framebuffer layout: <lineCount> lines by <lineLength> bytes, each byte holds 8 vertical pixels (LSB - top)
+class IOSDRenderTarget
+{
+public:
+	IOSDRenderTarget();
+	IOSDRenderTarget(const IOSDRenderTarget& that) = delete; // Copy constructor is forbidden here (C++11 feature)
+	virtual ~IOSDRenderTarget();
+
+	virtual const char* getName() = 0;
+
+	// <lines> - mask of lines changed since previously presented frame, <timestamp> - frame commit time (us)
+	// Returns false if target is busy (frame will be presented again)
+	virtual bool present(const uint8_t* frame, uint8_t lineCount, uint16_t lineLength, uint32_t lines, uint64_t timestamp) = 0;
+};
+
+#endif /* INTERFACES_IOSDRENDERTARGET_H_ */
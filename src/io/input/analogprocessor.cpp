@@ -0,0 +1,61 @@
+#include "analogprocessor.h"
+
+#include <string.h>
+
+// Pre-calculate per-axis constants, so per-frame processing contains only integer multiply/shift operations
+// Unused axis slots (count..JOYSTICK_MAX_AXES) get zero scale and always produce 0 value
+void AnalogProcessor::prepare(const AxisCalibration* calibrations, unsigned count, AxisCalibrationBatch& batch)
+{
+	memset(&batch, 0, sizeof(batch));
+
+	if (calibrations == nullptr)
+		return;
+
+	for (unsigned i = 0; i < count && i < JOYSTICK_MAX_AXES; i++)
+	{
+		const AxisCalibration& calibration = calibrations[i];
+
+		int32_t halfRange = (calibration.maximum - calibration.minimum) / 2;
+		if (halfRange < 1)
+			halfRange = 1;
+
+		// Use the largest from hardware flat zone and configured deadzone
+		int32_t deadzone = halfRange * calibration.deadzone / 100;
+		if (calibration.flat > deadzone)
+			deadzone = calibration.flat;
+		if (deadzone >= halfRange)
+			deadzone = halfRange - 1;
+
+		batch.center[i] = calibration.minimum + halfRange;
+		batch.deadzone[i] = deadzone;
+		batch.scale[i] = (127 << 16) / (halfRange - deadzone);
+		batch.inverted[i] = calibration.inverted ? 1 : 0;
+		batch.curve[i] = (int32_t)calibration.curve;
+	}
+}
+
+// Convert raw axis values into signed 8-bit values [-127..127] expected by cores (UIO_ASTICK)
+// Always processes JOYSTICK_MAX_AXES values (fixed trip count, no branches inside the loop body)
+void AnalogProcessor::process(const AxisCalibrationBatch& batch, const int32_t* raw, int8_t* out)
+{
+	for (unsigned i = 0; i < JOYSTICK_MAX_AXES; i++)
+	{
+		int32_t delta = raw[i] - batch.center[i];
+		int32_t negative = delta < 0;
+
+		// Cut deadzone and scale the rest to [0..127] range
+		int32_t magnitude = (negative ? -delta : delta) - batch.deadzone[i];
+		magnitude = magnitude < 0 ? 0 : magnitude;
+
+		int32_t value = (int32_t)(((int64_t)magnitude * batch.scale[i]) >> 16);
+		value = value > 127 ? 127 : value;
+
+		// Apply response curve (all variants calculated, the proper one selected without branching)
+		int32_t quadratic = value * value / 127;
+		int32_t cubic = value * value * value / (127 * 127);
+		value = batch.curve[i] == (int32_t)AxisResponseCurve::Quadratic ? quadratic : value;
+		value = batch.curve[i] == (int32_t)AxisResponseCurve::Cubic ? cubic : value;
+
+		out[i] = (int8_t)((negative ^ batch.inverted[i]) ? -value : value);
+	}
+}
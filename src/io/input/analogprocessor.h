@@ -0,0 +1,51 @@
+#ifndef IO_INPUT_ANALOGPROCESSOR_H_
+#define IO_INPUT_ANALOGPROCESSOR_H_
+
+#include <stdint.h>
+#include "../../common/consts.h"
+
+using namespace std;
+
+enum class AxisResponseCurve : uint8_t
+{
+	Linear = 0,
+	Quadratic,
+	Cubic
+};
+
+// Per-axis calibration. Initial values are taken from EVIOCGABS, the rest can be adjusted per device
+struct AxisCalibration
+{
+	int32_t minimum = -32768;
+	int32_t maximum = 32767;
+	int32_t flat = 0;							// Hardware-reported flat zone (in raw units)
+	uint8_t deadzone = 10;						// Additional deadzone (in percents of half-range)
+	bool inverted = false;
+	AxisResponseCurve curve = AxisResponseCurve::Linear;
+};
+typedef struct AxisCalibration AxisCalibration;
+
+// Calibration data pre-calculated for all axes of a single device.
+// Stored as structure of arrays so batch processing loop has no data dependencies between axes
+// and can be vectorized by compiler (NEON on Cortex-A9)
+struct AxisCalibrationBatch
+{
+	int32_t center[JOYSTICK_MAX_AXES];
+	int32_t deadzone[JOYSTICK_MAX_AXES];		// Total deadzone (in raw units)
+	int32_t scale[JOYSTICK_MAX_AXES];			// Q16 multiplier mapping [deadzone..half-range] to [0..127]
+	int32_t inverted[JOYSTICK_MAX_AXES];
+	int32_t curve[JOYSTICK_MAX_AXES];
+};
+typedef struct AxisCalibrationBatch AxisCalibrationBatch;
+
+class AnalogProcessor
+{
+public:
+	static void prepare(const AxisCalibration* calibrations, unsigned count, AxisCalibrationBatch& batch);
+	static void process(const AxisCalibrationBatch& batch, const int32_t* raw, int8_t* out);
+
+private:
+	AnalogProcessor() {}; // Static class, disallow objects creation
+};
+
+#endif /* IO_INPUT_ANALOGPROCESSOR_H_ */
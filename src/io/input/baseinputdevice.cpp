@@ -12,6 +12,7 @@
 #include "../../common/helpers/displayhelper.h"
 #include "../../common/helpers/stringhelper.h"
 #include "../../common/file/path/path.h"
+#include "devicecache.h"
 
 #define IS_BIT_SET(var, pos) ((var) & (1 << (pos)))
 
@@ -595,6 +596,29 @@ bool BaseInputDevice::init()
 	return result;
 }
 
+// Lightweight initialization using previously probed capabilities (no sysfs reads / type detection)
+bool BaseInputDevice::initFromCache(const DeviceCapabilities& capabilities)
+{
+	bool result = true;
+
+	openDevice();
+
+	index = getDeviceIndex();
+	model = capabilities.model;
+	type = capabilities.type;
+	deviceID.vid = capabilities.vid;
+	deviceID.pid = capabilities.pid;
+
+	return result;
+}
+
+// Fill probe results for the capabilities cache (identity fields are filled by InputDeviceCache::identify)
+void BaseInputDevice::getCapabilities(DeviceCapabilities& capabilities)
+{
+	capabilities.type = type;
+	capabilities.axisCount = 0;
+}
+
 const string BaseInputDevice::getDeviceModel()
 {
 	return InputDeviceHelper::getDeviceModel(fd);
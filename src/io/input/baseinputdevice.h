@@ -15,6 +15,8 @@
 
 using namespace std;
 
+struct DeviceCapabilities;
+
 class BaseInputDevice: public InputDevice
 {
 protected:
@@ -43,7 +45,9 @@ public:
 	int openDeviceWrite();
 	void closeDevice();
 
-	bool init();
+	virtual bool init();
+	virtual bool initFromCache(const DeviceCapabilities& capabilities);
+	virtual void getCapabilities(DeviceCapabilities& capabilities);
 	const string getDeviceModel();
 	const int getDeviceIndex();
 	VIDPID getDeviceVIDPID();
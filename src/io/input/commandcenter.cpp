@@ -5,9 +5,16 @@
 #include <linux/input.h>
 #include "../../common/consts.h"
 #include "../../common/messagetypes.h"
+#include "../../common/diagnostics/latencytracer.h"
 #include "../../common/events/events.h"
 #include "../../common/events/messagecenter.h"
+#include "../../common/timer/timerservice.h"
+#include "../../cores/coremanager.h"
 #include "../../gui/osd/osd.h"
+#include "../../gui/osd/osdpresenter.h"
+#include "inputpoll/inputpoller.h"
+#include "joystickreporter.h"
+#include "mouseemulator.h"
 #include "../../gui/menu/coreselectionmenu.h"
 
 CommandCenter& CommandCenter::instance()
@@ -17,10 +24,34 @@ CommandCenter& CommandCenter::instance()
 	return instance;
 }
 
-CommandCenter::CommandCenter()
+CommandCenter::CommandCenter() : m_menuChord({ KEY_LEFTALT, KEY_RIGHTALT }, KEY_F12), m_autofireChord({ KEY_LEFTCTRL, KEY_RIGHTCTRL }, KEY_KP0),
+	m_mouseJoystickChord({ KEY_LEFTCTRL, KEY_RIGHTCTRL }, KEY_KP5), m_repeatKey(0)
 {
 	TRACE("CommandCenter()");
 
+	m_autofireChord.requireAny({ KEY_LEFTALT, KEY_RIGHTALT });
+	m_mouseJoystickChord.requireAny({ KEY_LEFTALT, KEY_RIGHTALT });
+
+	// Repeat timer fires on timer service thread. Repeat is delivered via event queue,
+	// so menu is always accessed from the same thread as for regular key presses
+	m_repeatTimer.callback = [this]()
+	{
+		uint16_t key = m_repeatKey;
+		if (key != 0)
+		{
+			MessageCenter::defaultCenter().post(EVENT_KEY_REPEAT, this, new KeyRepeatEvent(key));
+		}
+	};
+
+	// Menu tick is delivered the same way (long name scrolling etc.). Nothing is posted while there is nothing to animate
+	m_menuTimer.callback = [this]()
+	{
+		if (OSD::instance().isTextScrolling())
+		{
+			MessageCenter::defaultCenter().post(EVENT_MENU_TICK, this, nullptr);
+		}
+	};
+
 	// Subscribe for input devices events
 	MessageCenter& center = MessageCenter::defaultCenter();
 	center.addObserver(EVENT_KEYBOARD, this);
@@ -48,6 +79,64 @@ CommandCenter::CommandCenter()
 		}
 	);
 
+	// Specific handler for menu navigation keys auto-repeat
+	center.addObserver(EVENT_KEY_REPEAT, this,
+		[](const EventObserver* obj, const EventMessageBase& event)
+		{
+			if (obj != nullptr)
+			{
+				CommandCenter* center = (CommandCenter*)obj;
+
+				KeyRepeatEvent* message = (KeyRepeatEvent*)event.payload;
+				if (center != nullptr && message != nullptr)
+				{
+					center->handleKeyRepeat(*message);
+				}
+			}
+			else
+			{
+				LOGERROR("Event handler called but unable to determine CommandCenter instance");
+			}
+		}
+	);
+
+	// Specific handler for menu animation tick
+	center.addObserver(EVENT_MENU_TICK, this,
+		[](const EventObserver* obj, const EventMessageBase&)
+		{
+			if (obj != nullptr)
+			{
+				CommandCenter* center = (CommandCenter*)obj;
+				center->handleMenuTick();
+			}
+			else
+			{
+				LOGERROR("Event handler called but unable to determine CommandCenter instance");
+			}
+		}
+	);
+
+	// Specific handler for menu folder scan progress (batches of entries arrive while folder is being read)
+	center.addObserver(EVENT_FOLDER_SCAN, this,
+		[](const EventObserver* obj, const EventMessageBase& event)
+		{
+			if (obj != nullptr)
+			{
+				CommandCenter* center = (CommandCenter*)obj;
+
+				FolderScanEvent* message = (FolderScanEvent*)event.payload;
+				if (center != nullptr && message != nullptr)
+				{
+					center->handleFolderScan(*message);
+				}
+			}
+			else
+			{
+				LOGERROR("Event handler called but unable to determine CommandCenter instance");
+			}
+		}
+	);
+
 	// Specific handler for tracking FPGA core start
 	center.addObserver(EVENT_CORE_STARTED, this,
 		[](const EventObserver* obj, const EventMessageBase& event)
@@ -68,6 +157,8 @@ CommandCenter::CommandCenter()
 			}
 		}
 	);
+
+	updateInputRoute();
 }
 
 CommandCenter::~CommandCenter()
@@ -77,6 +168,9 @@ CommandCenter::~CommandCenter()
 	// Unsubscribe from all notifications
 	MessageCenter& center = MessageCenter::defaultCenter();
 	center.removeObserver(this);
+
+	stopRepeat();
+	stopMenuTick();
 }
 
 // Helper methods
@@ -103,11 +197,39 @@ void CommandCenter::handleKeyboard(const MInputMessage& message)
 			}
 		}
 
-		// Step 1: Process menu command(s)
+		LatencyTracer& tracer = LatencyTracer::instance();
+		tracer.record(message.name, LatencyStageEnum::Mapper, message.timestamp);
+
+		// NumLock cycles keypad emulation modes (mouse / joystick 0 / joystick 1 / off)
+		MouseEmulator& emulator = MouseEmulator::instance();
+		if (keyboard->isKeyPressedEdge(KEY_NUMLOCK))
+		{
+			emu_mode_t mode = emulator.switchMode();
+			LOGINFO("Keypad emulation mode: %d", mode);
+
+			updateInputRoute();
+		}
+
+		if (emulator.getMode() != EMU_NONE)
+		{
+			emulator.setDigitalState(MouseEmulator::getKeypadState(keyboard->getKeysState()));
+		}
+
+		// Step 1: Process menu command(s). Menu changes are transferred to OSD asynchronously,
+		// presenter records Transfer stage once the frame reaches FPGA
+		OSDPresenter& presenter = OSDPresenter::instance();
+		presenter.traceInput(message.name, message.timestamp);
 		bool res = handleMenu(*keyboard);
+		presenter.traceInput("", 0);
+
+		// Step 2: Global hotkeys
+		if (!res)
+		{
+			handleGlobalKeys(*keyboard);
+		}
 
-		//if (!res)
-		//	res = handleGlobal(keyEvent);
+		// All events from the message processed - current state becomes previous for edge detection
+		keyboard->commitKeyState();
 	}
 	else
 	{
@@ -118,6 +240,8 @@ void CommandCenter::handleKeyboard(const MInputMessage& message)
 void CommandCenter::handleCoreStarted(const CoreStartedEvent& message)
 {
 	TRACE("%s: received %s event: value: '%s'", __PRETTY_FUNCTION__, EVENT_CORE_STARTED, message.coreName.c_str());
+
+	updateInputRoute();
 }
 
 // Handle everything related to menu
@@ -125,12 +249,11 @@ bool CommandCenter::handleMenu(Keyboard& keyboard)
 {
 	bool result = false;
 
-	bool prevF12Pressed = keyboard.getPrevKeyState(KEY_F12);
-	bool f12Pressed = keyboard.getKeyState(KEY_F12);
-	bool altPressed = keyboard.getKeyState(KEY_LEFTALT) | keyboard.getKeyState(KEY_RIGHTALT);
+	const KeyBitset& state = keyboard.getKeysState();
+	const KeyBitset& prevState = keyboard.getPrevKeysState();
 
-	// Reacting only on F12 press positive edge (0 -> 1 transition)
-	if (f12Pressed && altPressed && f12Pressed != prevF12Pressed)
+	// Reacting only on F12 press positive edge (0 -> 1 transition) while Alt is held
+	if (m_menuChord.match(state, prevState))
 	{
 		OSD& osd = OSD::instance();
 
@@ -139,21 +262,33 @@ bool CommandCenter::handleMenu(Keyboard& keyboard)
 			if (m_menu == nullptr)
 			{
 				m_menu = new CoreSelectionMenu();
-				((CoreSelectionMenu *)m_menu)->start();
 			}
 
+			// Folder scan runs in background, list is filled progressively
+			((CoreSelectionMenu *)m_menu)->start();
+
 			osd.showHighres();
+			startMenuTick();
 		}
 		else
 		{
 			osd.hide();
+			stopRepeat();
+			stopMenuTick();
+
+			// Unfinished folder scan is cancelled
+			if (m_menu != nullptr)
+			{
+				((CoreSelectionMenu *)m_menu)->stop();
+			}
 		}
 
 		TRACE("OSD: %s", m_isMenuActive ? "off" : "on");
 
 		m_isMenuActive = !m_isMenuActive;
+
+		updateInputRoute();
 	}
-	keyboard.setPrevKeyState(KEY_F12, f12Pressed);
 
 	if (m_isMenuActive)
 	{
@@ -165,59 +300,59 @@ bool CommandCenter::handleMenu(Keyboard& keyboard)
 		}
 		CoreSelectionMenu& menu = *menuPtr;
 
-		bool prevCancelPressed = keyboard.getPrevKeyState(KEY_ESC);
-		bool cancelPressed = keyboard.getKeyState(KEY_ESC);
-
-		bool prevEnterPressed = keyboard.getPrevKeyState(KEY_ENTER) | keyboard.getPrevKeyState(KEY_KPENTER);
-		bool enterPressed = keyboard.getKeyState(KEY_ENTER) | keyboard.getKeyState(KEY_KPENTER);
-
-		bool prevUpPressed = keyboard.getPrevKeyState(KEY_UP);
-		bool prevDownPressed = keyboard.getPrevKeyState(KEY_DOWN);
-		bool upPressed = keyboard.getKeyState(KEY_UP);
-		bool downPressed = keyboard.getKeyState(KEY_DOWN);
-
-		bool prevPgUpPressed = keyboard.getPrevKeyState(KEY_PAGEUP);
-		bool prevPgDnPressed = keyboard.getPrevKeyState(KEY_PAGEDOWN);
-		bool pgUpPressed = keyboard.getKeyState(KEY_PAGEUP);
-		bool pgDnPressed = keyboard.getKeyState(KEY_PAGEDOWN);
-
 		TRACE("Keypress handled");
 
-		// React on paging keys
-		if (pgUpPressed && !prevPgUpPressed)
-		{
-			menu.pageUp();
-		}
-		else if (pgDnPressed && !prevPgDnPressed)
-		{
-			menu.pageDown();
-		}
-		// React on cursor keys
-		else if (upPressed /*&& !prevUpPressed*/)
-		{
-			menu.moveUp();
-		}
-		else if (downPressed /*&& !prevDownPressed*/)
+		// Navigation keys react on press, then repeat (driven by timer) while held.
+		// Kernel auto-repeat events are ignored, so repeat timing doesn't depend on keyboard settings
+		static const uint16_t navigationKeys[] = { KEY_UP, KEY_DOWN, KEY_PAGEUP, KEY_PAGEDOWN };
+
+		uint16_t repeatKey = m_repeatKey;
+		if (repeatKey != 0 && !state.test(repeatKey))
 		{
-			menu.moveDown();
+			stopRepeat();
 		}
-		// React on cancel / enter
-		else if (cancelPressed && ~prevCancelPressed)
+
+		bool isNavigation = false;
+		for (uint16_t key : navigationKeys)
 		{
-			menu.cancel();
+			if (keyboard.isKeyPressedEdge(key))
+			{
+				handleMenuKey(key);
+				startRepeat(key);
+
+				isNavigation = true;
+				break;
+			}
 		}
-		else if (enterPressed && !prevEnterPressed)
+
+		// React on cancel / enter (positive edge only)
+		if (!isNavigation)
 		{
-			menu.enter();
+			if (keyboard.isKeyPressedEdge(KEY_ESC))
+			{
+				menu.cancel();
+			}
+			else if (keyboard.isKeyPressedEdge(KEY_ENTER) || keyboard.isKeyPressedEdge(KEY_KPENTER))
+			{
+				menu.enter();
+			}
+			else if (keyboard.isKeyPressedEdge(KEY_BACKSPACE))
+			{
+				menu.eraseTypeAhead();
+			}
+			else
+			{
+				// Type-ahead: letters / digits jump to (and narrow the list to) matching items
+				for (uint16_t key = KEY_1; key <= KEY_M; key++)
+				{
+					char symbol = Keyboard::getKeyChar(key);
+					if (symbol != '\0' && keyboard.isKeyPressedEdge(key))
+					{
+						menu.typeAhead(symbol);
+					}
+				}
+			}
 		}
-
-		keyboard.setPrevKeyState(KEY_UP, upPressed);
-		keyboard.setPrevKeyState(KEY_DOWN, downPressed);
-		keyboard.setPrevKeyState(KEY_PAGEUP, pgUpPressed);
-		keyboard.setPrevKeyState(KEY_PAGEDOWN, pgDnPressed);
-		keyboard.setPrevKeyState(KEY_ESC, cancelPressed);
-		keyboard.setPrevKeyState(KEY_ENTER, enterPressed);
-		keyboard.setPrevKeyState(KEY_KPENTER, enterPressed);
 	}
 
 	// Handle in-menu actions
@@ -251,7 +386,157 @@ bool CommandCenter::handleMenu(Keyboard& keyboard)
 }
 
 
+// Single menu navigation step (for both initial press and repeats)
+bool CommandCenter::handleMenuKey(uint16_t key)
+{
+	bool result = false;
+
+	CoreSelectionMenu* menu = (CoreSelectionMenu *)m_menu;
+	if (!m_isMenuActive || menu == nullptr)
+		return result;
+
+	result = true;
+
+	switch (key)
+	{
+		case KEY_UP:
+			menu->moveUp();
+			break;
+		case KEY_DOWN:
+			menu->moveDown();
+			break;
+		case KEY_PAGEUP:
+			menu->pageUp();
+			break;
+		case KEY_PAGEDOWN:
+			menu->pageDown();
+			break;
+		default:
+			result = false;
+			break;
+	}
+
+	return result;
+}
+
+void CommandCenter::handleKeyRepeat(const KeyRepeatEvent& event)
+{
+	// Key could be released while repeat event was waiting in the queue
+	if (event.key != m_repeatKey)
+		return;
+
+	handleMenuKey(event.key);
+}
+
+void CommandCenter::handleMenuTick()
+{
+	CoreSelectionMenu* menu = (CoreSelectionMenu *)m_menu;
+	if (!m_isMenuActive || menu == nullptr)
+		return;
+
+	menu->tick();
+}
+
+void CommandCenter::handleFolderScan(const FolderScanEvent& event)
+{
+	CoreSelectionMenu* menu = (CoreSelectionMenu *)m_menu;
+	if (menu == nullptr)
+		return;
+
+	menu->onFolderScan(event);
+}
+
+// Hotkeys available both in menu and in-game
+bool CommandCenter::handleGlobalKeys(Keyboard& keyboard)
+{
+	bool result = false;
+
+	const KeyBitset& state = keyboard.getKeysState();
+	const KeyBitset& prevState = keyboard.getPrevKeysState();
+
+	// Ctrl+Alt+Keypad 0 cycles autofire rate (off / fast / medium / slow) for fire buttons of all ports
+	if (m_autofireChord.match(state, prevState))
+	{
+		JoystickReporter& reporter = JoystickReporter::instance();
+
+		AutofireRateEnum rate = AutofireRateEnum::_from_integral((reporter.getAutofireRate()._to_integral() + 1) % AutofireRateEnum::_size());
+		for (uint8_t port = 0; port < MAX_JOYSTICKS; port++)
+		{
+			reporter.setAutofire(port, rate == +AutofireRateEnum::Off ? 0 : JOY_BTN1 | JOY_BTN2);
+		}
+		reporter.setAutofireRate(rate);
+
+		LOGINFO("Autofire: %s", rate._to_string());
+
+		result = true;
+	}
+
+	// Ctrl+Alt+Keypad 5 toggles first joystick as mouse emulation source (used in mouse mode only)
+	if (m_mouseJoystickChord.match(state, prevState))
+	{
+		MouseEmulator& emulator = MouseEmulator::instance();
+		emulator.setJoystickSource(!emulator.isJoystickSource());
+
+		LOGINFO("Joystick to mouse: %s", emulator.isJoystickSource() ? "on" : "off");
+
+		result = true;
+	}
+
+	return result;
+}
+
+void CommandCenter::startRepeat(uint16_t key)
+{
+	m_repeatKey = key;
+	TimerService::instance().schedule(m_repeatTimer, REPEATDELAY, REPEATRATE);
+}
+
+void CommandCenter::stopRepeat()
+{
+	m_repeatKey = 0;
+	TimerService::instance().cancel(m_repeatTimer);
+}
+
+void CommandCenter::startMenuTick()
+{
+	TimerService::instance().schedule(m_menuTimer, OSD_SCROLL_INTERVAL, OSD_SCROLL_INTERVAL);
+}
+
+void CommandCenter::stopMenuTick()
+{
+	TimerService::instance().cancel(m_menuTimer);
+}
+
 // Event handlers
+// In-game (no menu shown) keyboard and mouse are passed by InputPoller directly to the core adapter.
+// Only keys CommandCenter reacts on are still delivered here: menu / autofire / joystick-to-mouse chords, NumLock and keypad (while emulation is active).
+// F12, NumLock and emulation keypad are reserved - they never reach the core
+void CommandCenter::updateInputRoute()
+{
+	KeyBitset hotkeys;
+	KeyBitset reserved;
+
+	m_menuChord.getKeys(hotkeys);
+	m_autofireChord.getKeys(hotkeys);
+	m_mouseJoystickChord.getKeys(hotkeys);
+	hotkeys.set(KEY_NUMLOCK, true);
+
+	reserved.set(m_menuChord.getTrigger(), true);
+	reserved.set(KEY_NUMLOCK, true);
+
+	if (MouseEmulator::instance().getMode() != EMU_NONE)
+	{
+		MouseEmulator::getKeypadKeys(hotkeys);
+		MouseEmulator::getKeypadKeys(reserved);
+	}
+
+	ICoreInterface* core = m_isMenuActive ? nullptr : CoreManager::instance().getCurrentCore();
+
+	InputPoller& poller = InputPoller::instance();
+	poller.setHotkeys(hotkeys, reserved);
+	poller.setDirectCore(core);
+}
+
 void CommandCenter::onMouse(const EventMessageBase& event)
 {
 	TRACE("CommandCenter::onMouse()");
@@ -271,5 +556,8 @@ void CommandCenter::onMessageEvent(const EventMessageBase& event)
 	// Extract payload as MInputMessage
 	MInputMessage* payload = (MInputMessage*)event.payload;
 
+	// Latency from kernel event timestamp till delivery from the queue
+	LatencyTracer::instance().record(payload->name, LatencyStageEnum::Dispatch, payload->timestamp);
+
 	//TRACE("%s: notification for fd:%x, type:'%s'", __PRETTY_FUNCTION__, payload->deviceID, payload->deviceType._to_string());
 }
@@ -4,9 +4,11 @@
 #include <atomic>
 #include "../../common/messagetypes.h"
 #include "../../common/events/events.h"
+#include "../../common/timer/timerwheel.h"
 #include "../../gui/menu/basemenu.h"
 #include "inputmanager.h"
 #include "keyboard.h"
+#include "keychord.h"
 
 using namespace std;
 
@@ -17,13 +19,25 @@ enum MenuTypeEnum
 	CoreSpecific
 };
 
-class CommandCenter : public EventObserver
+class CommandCenter : public EventObserver, EventSource
 {
 private:
 	atomic<bool> m_isMenuActive;
 	MenuTypeEnum m_menuType = MenuTypeEnum::CoreSelection;
 	BaseMenu* m_menu = nullptr;
 
+	// Hotkeys
+	KeyChord m_menuChord;		// Alt+F12 - toggle OSD menu
+	KeyChord m_autofireChord;	// Ctrl+Alt+Keypad 0 - cycle joystick autofire rate
+	KeyChord m_mouseJoystickChord;	// Ctrl+Alt+Keypad 5 - toggle first joystick as mouse emulation source
+
+	// Menu navigation key repeat (REPEATDELAY / REPEATRATE)
+	Timer m_repeatTimer;
+	atomic<uint16_t> m_repeatKey;
+
+	// Menu animation tick (OSD_SCROLL_INTERVAL), active while menu is shown
+	Timer m_menuTimer;
+
 public:
 	// Singleton instance
 	static CommandCenter& instance();
@@ -38,8 +52,19 @@ protected:
 	void handleCoreStarted(const CoreStartedEvent& message);
 
 	bool handleMenu(Keyboard& keyboard);
+	bool handleMenuKey(uint16_t key);
+	void handleKeyRepeat(const KeyRepeatEvent& event);
+	void handleMenuTick();
+	void handleFolderScan(const FolderScanEvent& event);
 	bool handleGlobalKeys(Keyboard& keyboard);
 
+	void startRepeat(uint16_t key);
+	void stopRepeat();
+	void startMenuTick();
+	void stopMenuTick();
+
+	void updateInputRoute();
+
 // Event handlers
 protected:
 	void onMouse(const EventMessageBase& event);
@@ -0,0 +1,389 @@
+#include "devicecache.h"
+
+#include "../../common/logger/logger.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+#include <sys/ioctl.h>
+#include <linux/input.h>
+#include "../../3rdparty/tinyformat/tinyformat.h"
+#include "../../common/file/path/path.h"
+#include "../../common/system/sysmanager.h"
+#include "inputdevicehelper.h"
+#include "inputmanager.h"
+
+#define DEVICE_CACHE_HEADER "# MiSTer input device capabilities cache v2"
+
+// DeviceCapabilities struct
+
+string DeviceCapabilities::getKey() const
+{
+	string result = tfm::format("%04x:%04x:%04x:%s:%s", bus, vid, pid, interface, model);
+
+	return result;
+}
+
+// Compares probe results only (identity is the same by key)
+bool DeviceCapabilities::isSameProbe(const DeviceCapabilities& that) const
+{
+	bool result = type == that.type && axisCount == that.axisCount;
+
+	for (unsigned i = 0; result && i < axisCount && i < JOYSTICK_MAX_AXES; i++)
+	{
+		result =
+			axisCodes[i] == that.axisCodes[i] &&
+			calibrations[i].minimum == that.calibrations[i].minimum &&
+			calibrations[i].maximum == that.calibrations[i].maximum &&
+			calibrations[i].flat == that.calibrations[i].flat;
+	}
+
+	return result;
+}
+
+// InputDeviceCache class
+
+InputDeviceCache& InputDeviceCache::instance()
+{
+	static InputDeviceCache instance;
+
+	return instance;
+}
+
+bool InputDeviceCache::load()
+{
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexCache);
+
+	bool result = readCacheFile();
+
+	return result;
+}
+
+bool InputDeviceCache::save()
+{
+	bool result = false;
+
+	string path = getCacheFilePath();
+	string tempPath = path + ".tmp";
+
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexCache);
+
+	// Write into temporary file first, so power loss during write won't leave broken cache
+	ofstream cacheFile(tempPath.c_str(), ios::out | ios::trunc);
+	if (cacheFile.is_open())
+	{
+		cacheFile << DEVICE_CACHE_HEADER << endl;
+
+		for (auto& it : m_devices)
+		{
+			cacheFile << serialize(it.second) << endl;
+		}
+
+		cacheFile.close();
+
+		if (!cacheFile.fail() && rename(tempPath.c_str(), path.c_str()) == 0)
+		{
+			result = true;
+		}
+	}
+
+	if (!result)
+	{
+		LOGWARN("%s: unable to save input devices cache to '%s'", __PRETTY_FUNCTION__, path.c_str());
+	}
+
+	return result;
+}
+
+void InputDeviceCache::dispose()
+{
+	stop();
+
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexPending);
+
+		m_pending.clear();
+	}
+
+	// Changes made after the last background save
+	if (m_modified.exchange(false))
+	{
+		save();
+	}
+}
+
+// Looks up cached probe results using identity fields of <capabilities>
+// Returns true and fills probe fields if device is known
+bool InputDeviceCache::find(DeviceCapabilities& capabilities)
+{
+	bool result = false;
+
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexCache);
+
+	// Devices are probed in parallel - cache is loaded by the first lookup only
+	if (!m_loaded)
+	{
+		readCacheFile();
+	}
+
+	auto it = m_devices.find(capabilities.getKey());
+	if (it != m_devices.end())
+	{
+		capabilities = it->second;
+		result = true;
+	}
+
+	return result;
+}
+
+// Cache is saved later by background thread (use scheduleSave())
+void InputDeviceCache::update(const DeviceCapabilities& capabilities)
+{
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexCache);
+
+	m_devices[capabilities.getKey()] = capabilities;
+	m_modified = true;
+}
+
+// Queue device for background probe. Probing is postponed, so it won't compete with startup / hotplug processing
+void InputDeviceCache::scheduleRevalidation(const string& name)
+{
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexPending);
+
+	m_pending.push_back(name);
+
+	// Start background thread on first demand
+	if (m_stopped)
+	{
+		start();
+	}
+
+	m_pendingCondition.notify_one();
+}
+
+// Save changes in background. Updates arrived meanwhile (e.g. several new devices at startup) are saved together
+void InputDeviceCache::scheduleSave()
+{
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexPending);
+
+	// Start background thread on first demand
+	if (m_stopped)
+	{
+		start();
+	}
+
+	m_pendingCondition.notify_one();
+}
+
+// Retrieve device identity: bus type, VID, PID (single EVIOCGID call instead of sysfs reads), interface and name
+bool InputDeviceCache::identify(int fd, DeviceCapabilities& capabilities)
+{
+	bool result = false;
+
+	if (!InputDeviceHelper::isDescriptorValid(fd))
+		return result;
+
+	struct input_id id;
+	if (ioctl(fd, EVIOCGID, &id) >= 0)
+	{
+		capabilities.bus = id.bustype;
+		capabilities.vid = id.vendor;
+		capabilities.pid = id.product;
+		capabilities.interface = InputDeviceHelper::getDeviceInterface(fd);
+		capabilities.model = InputDeviceHelper::getDeviceModel(fd);
+
+		result = true;
+	}
+
+	return result;
+}
+
+string InputDeviceCache::getCacheFilePath()
+{
+	string result = Path::combine(sysmanager::getDataRootDir(), CONFIG_DIR).combine(INPUT_DEVICE_CACHE_FILE).toString();
+
+	return result;
+}
+
+// Helper methods
+
+// Should be called with m_mutexCache locked
+bool InputDeviceCache::readCacheFile()
+{
+	bool result = false;
+
+	string path = getCacheFilePath();
+
+	m_devices.clear();
+	m_loaded = true;
+
+	ifstream cacheFile(path.c_str());
+	if (cacheFile.is_open())
+	{
+		string line;
+		getline(cacheFile, line);
+
+		// Ignore cache files with unknown format
+		if (line == DEVICE_CACHE_HEADER)
+		{
+			while (getline(cacheFile, line))
+			{
+				DeviceCapabilities capabilities;
+				if (deserialize(line, capabilities))
+				{
+					m_devices[capabilities.getKey()] = capabilities;
+				}
+			}
+
+			result = true;
+		}
+		else
+		{
+			LOGWARN("%s: unsupported cache file format '%s'. Cache will be rebuilt", __PRETTY_FUNCTION__, path.c_str());
+		}
+
+		cacheFile.close();
+	}
+
+	DEBUG("%s: %d device(s) loaded from '%s'", __PRETTY_FUNCTION__, m_devices.size(), path.c_str());
+
+	return result;
+}
+
+void InputDeviceCache::revalidate(const string& name)
+{
+	DeviceCapabilities probed;
+	if (!InputManager::instance().probeCapabilities(name, probed))
+	{
+		// Device was disconnected already
+		return;
+	}
+
+	DeviceCapabilities cached = probed;
+	bool isCached = find(cached);
+
+	if (!isCached || !cached.isSameProbe(probed))
+	{
+		LOGWARN("Input device '%s' (%s) capabilities changed. Cache updated, changes will be applied after reconnect", probed.model.c_str(), name.c_str());
+
+		update(probed);
+	}
+	else
+	{
+		TRACE("%s: cached capabilities for '%s' (%s) confirmed", __PRETTY_FUNCTION__, probed.model.c_str(), name.c_str());
+	}
+}
+
+// Format: <bus> <vid> <pid> <interface> <type> <axisCount> [<code> <min> <max> <flat>] * axisCount <name>
+// Empty interface is stored as '-'
+string InputDeviceCache::serialize(const DeviceCapabilities& capabilities)
+{
+	stringstream ss;
+
+	const string& interface = capabilities.interface.empty() ? "-" : capabilities.interface;
+	ss << tfm::format("%04x %04x %04x %s %d %d", capabilities.bus, capabilities.vid, capabilities.pid, interface,
+		capabilities.type._to_integral(), capabilities.axisCount);
+
+	for (unsigned i = 0; i < capabilities.axisCount && i < JOYSTICK_MAX_AXES; i++)
+	{
+		const AxisCalibration& calibration = capabilities.calibrations[i];
+		ss << tfm::format(" %d %d %d %d", capabilities.axisCodes[i], calibration.minimum, calibration.maximum, calibration.flat);
+	}
+
+	ss << " " << capabilities.model;
+
+	return ss.str();
+}
+
+bool InputDeviceCache::deserialize(const string& line, DeviceCapabilities& capabilities)
+{
+	bool result = false;
+
+	if (line.empty() || line[0] == '#')
+		return result;
+
+	istringstream ss(line);
+
+	unsigned type = 0, axisCount = 0;
+	ss >> hex >> capabilities.bus >> capabilities.vid >> capabilities.pid >> dec >> capabilities.interface >> type >> axisCount;
+
+	if (capabilities.interface == "-")
+	{
+		capabilities.interface.clear();
+	}
+
+	if (ss.fail() || type >= InputDeviceTypeEnum::_size() || axisCount > JOYSTICK_MAX_AXES)
+		return result;
+
+	capabilities.type = InputDeviceTypeEnum::_from_integral(type);
+	capabilities.axisCount = axisCount;
+
+	for (unsigned i = 0; i < axisCount; i++)
+	{
+		AxisCalibration& calibration = capabilities.calibrations[i];
+		ss >> capabilities.axisCodes[i] >> calibration.minimum >> calibration.maximum >> calibration.flat;
+	}
+
+	// The rest of the line is device name (can contain spaces)
+	ss >> ws;
+	getline(ss, capabilities.model);
+
+	result = !ss.fail();
+
+	return result;
+}
+
+// Runnable override method(s)
+
+// Async thread body
+void InputDeviceCache::run()
+{
+	TRACE("InputDeviceCache: thread started with tid: %d (0x%x)", m_thread_id, m_thread_id);
+
+	// Give startup / hotplug processing a chance to complete first
+	for (int i = 0; i < DEVICE_CACHE_REVALIDATION_DELAY / 100 && !m_stop; i++)
+	{
+		usleep(100 * 1000);
+	}
+
+	while (!m_stop)
+	{
+		string name;
+		bool isIdle = false;
+
+		{
+			// Lock parallel threads to access (active till the end of the block)
+			unique_lock<mutex> lock(m_mutexPending);
+
+			m_pendingCondition.wait_for(lock, chrono::milliseconds(100), [this]() { return !m_pending.empty() || m_modified; });
+
+			if (!m_pending.empty())
+			{
+				name = m_pending.front();
+				m_pending.pop_front();
+			}
+
+			isIdle = m_pending.empty();
+		}
+
+		if (!name.empty())
+		{
+			revalidate(name);
+		}
+
+		// All queued devices are processed - save changes with single write
+		if (isIdle && m_modified.exchange(false))
+		{
+			save();
+		}
+	}
+}
@@ -0,0 +1,96 @@
+#ifndef IO_INPUT_DEVICECACHE_H_
+#define IO_INPUT_DEVICECACHE_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include "../../common/consts.h"
+#include "../../common/types.h"
+#include "../../common/thread/runnable.h"
+#include "analogprocessor.h"
+
+using namespace std;
+
+// Device capabilities as detected by full ioctl probe
+// Identity fields (bus, vid, pid, interface, model) are always queried from the device itself (EVIOCGID + EVIOCGPHYS + EVIOCGNAME)
+struct DeviceCapabilities
+{
+	// Identity
+	uint16_t bus = 0;
+	uint16_t vid = 0;
+	uint16_t pid = 0;
+	string interface;			// Interface of composite device ("input0", "input1", ...), empty if not reported
+	string model;
+
+	// Cached probe results
+	InputDeviceTypeEnum type = InputDeviceTypeEnum::Unknown;
+	uint8_t axisCount = 0;
+	uint16_t axisCodes[JOYSTICK_MAX_AXES] = { 0 };
+	AxisCalibration calibrations[JOYSTICK_MAX_AXES];
+
+	string getKey() const;
+	bool isSameProbe(const DeviceCapabilities& that) const;
+};
+typedef struct DeviceCapabilities DeviceCapabilities;
+typedef map<string, DeviceCapabilities> DeviceCapabilitiesMap;
+
+// Persistent cache of input device capabilities (keyed by bus / VID / PID / interface / name)
+// Known devices are created from the cache without full probing. Cached data is re-validated
+// in background thread some time later, cache is updated only if device reports something different.
+// Changes are saved by the same background thread, so device hotplug never waits for file write
+class InputDeviceCache : public Runnable
+{
+protected:
+	mutex m_mutexCache;
+	DeviceCapabilitiesMap m_devices;
+	bool m_loaded = false;				// Guarded by m_mutexCache
+	atomic<bool> m_modified { false };	// Cache has changes not saved yet
+
+	// Devices (event<N> names) waiting for background probe
+	mutex m_mutexPending;
+	condition_variable m_pendingCondition;
+	deque<string> m_pending;
+
+public:
+	// Singleton instance
+	static InputDeviceCache& instance();
+	InputDeviceCache(InputDeviceCache&&) = delete;						// Disable move constructor (C++11 feature)
+	InputDeviceCache(const InputDeviceCache& that) = delete; 			// Disable copy constructor (C++11 feature)
+	InputDeviceCache& operator =(InputDeviceCache const&) = delete;		// Disable assignment operator (C++11 feature)
+	virtual ~InputDeviceCache() {};
+
+public:
+	bool load();
+	bool save();
+	void dispose();
+
+	bool find(DeviceCapabilities& capabilities);
+	void update(const DeviceCapabilities& capabilities);
+	void scheduleRevalidation(const string& name);
+	void scheduleSave();
+
+	static bool identify(int fd, DeviceCapabilities& capabilities);
+	static string getCacheFilePath();
+
+// Helper methods
+protected:
+	bool readCacheFile();
+	void revalidate(const string& name);
+
+	static string serialize(const DeviceCapabilities& capabilities);
+	static bool deserialize(const string& line, DeviceCapabilities& capabilities);
+
+// Runnable override method(s)
+protected:
+	// Async thread body
+	void run();
+
+private:
+	InputDeviceCache() : Runnable("device_cache") {};	// Disable explicit object creation (only singleton instance allowed)
+};
+
+#endif /* IO_INPUT_DEVICECACHE_H_ */
@@ -37,7 +37,7 @@ struct InputDevice
 
 // Debug methods
 public:
-	string dumpDeviceType()
+	string dumpDeviceType() const
 	{
 		string result = type._to_string();
 
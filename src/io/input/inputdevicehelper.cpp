@@ -2,6 +2,8 @@
 
 #include "../../common/logger/logger.h"
 
+#include <string.h>
+
 const string InputDeviceHelper::getDeviceModel(int fd)
 {
 	static const int EVENT_BUFFER_SIZE = 256;
@@ -18,6 +20,27 @@ const string InputDeviceHelper::getDeviceModel(int fd)
 	return result;
 }
 
+// Interface part of physical path ("input1" for "usb-ff540000.usb-1.2/input1"). Composite devices
+// (e.g. keyboard with media keys, gamepad with touchpad) have the same VID / PID / name on each interface.
+// Bus / port part is skipped, so the device is recognized in any USB port
+const string InputDeviceHelper::getDeviceInterface(int fd)
+{
+	static const int PHYS_BUFFER_SIZE = 256;
+
+	char phys[PHYS_BUFFER_SIZE] = { 0 };
+
+	string result;
+
+	int res = ioctl(fd, EVIOCGPHYS(PHYS_BUFFER_SIZE - 1), phys);
+	if (res > 0)
+	{
+		const char* separator = strrchr(phys, '/');
+		result = separator != nullptr ? separator + 1 : "";
+	}
+
+	return result;
+}
+
 InputDeviceTypeEnum InputDeviceHelper::getDeviceType(int fd)
 {
 	InputDeviceTypeEnum result = InputDeviceTypeEnum::Unknown;
@@ -30,6 +30,7 @@ class InputDeviceHelper
 {
 public:
 	static const string getDeviceModel(int fd);
+	static const string getDeviceInterface(int fd);
 	static InputDeviceTypeEnum getDeviceType(int fd);
 	static uint32_t getDeviceEventBits(int fd, BitType* bit_ev, size_t length);
 	static BitType* getDeviceKeyBits(int fd, BitType* bit_key, size_t length);
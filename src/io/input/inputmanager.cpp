@@ -3,6 +3,7 @@
 #include "../../common/logger/logger.h"
 
 #include <algorithm>
+#include <chrono>
 #include <ostream>
 #include <sys/inotify.h>
 #include <sys/poll.h>
@@ -13,6 +14,7 @@
 #include "mouse.h"
 #include "joystick.h"
 #include "keyboard.h"
+#include "joystickreporter.h"
 #include "../../3rdparty/tinyformat/tinyformat.h"
 #include "../../common/consts.h"
 #include "../../common/messagetypes.h"
@@ -20,6 +22,7 @@
 #include "../../common/file/scandir/scandir.h"
 #include "../../common/file/filemanager.h"
 #include "../../common/helpers/collectionhelper.h"
+#include "../../common/thread/threadpool.h"
 
 
 InputManager& InputManager::instance()
@@ -51,11 +54,11 @@ InputManager::~InputManager()
 	MessageCenter& center = MessageCenter::defaultCenter();
 	center.removeObserver(this);
 
+	// Stop the poller first, so devices are released while nobody polls them
+	InputPoller::instance().dispose();
+
 	// Reset information about all registered input devices
 	reset();
-
-	// Ensure that poller is stopped
-	InputPoller::instance().dispose();
 }
 
 BaseInputDevice* InputManager::findInputDeviceByName(const string& name)
@@ -106,10 +109,28 @@ BaseInputDeviceMap& InputManager::detectDevices()
 	auto devices = scan.getScanResults();
 	if (devices.size() > 0)
 	{
-		for_each(devices.begin(), devices.end(),
-			[&](DirectoryEntry& entry)
+		auto started = chrono::steady_clock::now();
+
+		// Probe devices in parallel (each probe mostly waits for ioctl / sysfs replies)
+		// Results are stored by scan index, so devices are registered in the same (alphabetical) order as before
+		vector<BaseInputDevice*> resolved(devices.size(), nullptr);
+
+		ThreadPool::parallelFor(devices.size(), INPUT_PROBE_THREADS, "input_probe",
+			[&](size_t index)
+			{
+				const string& name = devices[index].name;
+				auto probeStarted = chrono::steady_clock::now();
+
+				resolved[index] = resolveDevice(name);
+
+				long duration = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - probeStarted).count();
+				LOGINFO("Input device '%s' probed in %.1fms", name.c_str(), duration / 1000.0);
+			}
+		);
+
+		for_each(resolved.begin(), resolved.end(),
+			[&](BaseInputDevice* inputDevice)
 			{
-				BaseInputDevice* inputDevice = resolveDevice(entry.name);
 				if (inputDevice != nullptr)
 				{
 					// Register device in correspondent collections
@@ -118,6 +139,9 @@ BaseInputDeviceMap& InputManager::detectDevices()
 			}
 		);
 
+		long total = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - started).count();
+		LOGINFO("%d input device(s) probed in %.1fms", devices.size(), total / 1000.0);
+
 		// Info logging
 		LOGINFO(dumpDevicesMap().c_str());
 		// -Info logging
@@ -159,13 +183,22 @@ BaseInputDevice* InputManager::resolveDevice(const string& name)
 
 	if (filemanager::isFileExist(path.c_str()))
 	{
+		InputDeviceCache& cache = InputDeviceCache::instance();
+		DeviceCapabilities capabilities;
+		bool isIdentified = false;
+		bool isCached = false;
+
 		// Query device for properties
 		int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK);
 		if (InputDeviceHelper::isDescriptorValid(fd))
 		{
+			// Known devices (same bus / VID / PID / interface / name) skip capabilities probing
+			isIdentified = InputDeviceCache::identify(fd, capabilities);
+			isCached = isIdentified && cache.find(capabilities);
+
 			// Get basic device info without creating heavy structures / class instances
-			InputDeviceTypeEnum type = InputDeviceHelper::getDeviceType(fd);
-			string model = InputDeviceHelper::getDeviceModel(fd);
+			InputDeviceTypeEnum type = isCached ? capabilities.type : InputDeviceHelper::getDeviceType(fd);
+			string model = isIdentified ? capabilities.model : InputDeviceHelper::getDeviceModel(fd);
 
 			close(fd);
 
@@ -175,27 +208,31 @@ BaseInputDevice* InputManager::resolveDevice(const string& name)
 			}
 			else
 			{
-				switch (type)
-				{
-					case InputDeviceTypeEnum::Keyboard:
-						result = new Keyboard(name, path);
-						break;
-					case InputDeviceTypeEnum::Mouse:
-						result = new Mouse(name, path);
-						break;
-					case InputDeviceTypeEnum::Joystick:
-						new Joystick(name, path);
-						break;
-					default:
-						break;
-				};
+				result = createDevice(type, name, path);
 			}
 		}
 
 		// Initialize device
 		if (result != nullptr)
 		{
-			result->init();
+			if (isCached)
+			{
+				result->initFromCache(capabilities);
+
+				// Cached data will be checked against the real device later (in background)
+				cache.scheduleRevalidation(name);
+			}
+			else
+			{
+				result->init();
+
+				if (isIdentified)
+				{
+					result->getCapabilities(capabilities);
+					cache.update(capabilities);
+					cache.scheduleSave();
+				}
+			}
 		}
 	}
 	else
@@ -206,6 +243,59 @@ BaseInputDevice* InputManager::resolveDevice(const string& name)
 	return result;
 }
 
+// Full (non-cached) device probe. Used for cached capabilities re-validation
+bool InputManager::probeCapabilities(const string& name, DeviceCapabilities& capabilities)
+{
+	bool result = false;
+
+	string path = Path::combine(LINUX_DEVICE_INPUT, name).toString();
+
+	int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK);
+	if (InputDeviceHelper::isDescriptorValid(fd))
+	{
+		result = InputDeviceCache::identify(fd, capabilities);
+		capabilities.type = InputDeviceHelper::getDeviceType(fd);
+
+		close(fd);
+	}
+
+	if (result)
+	{
+		BaseInputDevice* device = createDevice(capabilities.type, name, path);
+		if (device != nullptr)
+		{
+			device->init();
+			device->getCapabilities(capabilities);
+
+			delete device;
+		}
+	}
+
+	return result;
+}
+
+BaseInputDevice* InputManager::createDevice(InputDeviceTypeEnum type, const string& name, const string& path)
+{
+	BaseInputDevice* result = nullptr;
+
+	switch (type)
+	{
+		case InputDeviceTypeEnum::Keyboard:
+			result = new Keyboard(name, path);
+			break;
+		case InputDeviceTypeEnum::Mouse:
+			result = new Mouse(name, path);
+			break;
+		case InputDeviceTypeEnum::Joystick:
+			result = new Joystick(name, path);
+			break;
+		default:
+			break;
+	};
+
+	return result;
+}
+
 // Helper methods
 bool InputManager::isDeviceTypeAllowed(InputDeviceTypeEnum type)
 {
@@ -287,6 +377,7 @@ void InputManager::addInputDevice(BaseInputDevice* inputDevice)
 			break;
 		case InputDeviceTypeEnum::Joystick:
 			m_joysticks.insert({name, inputDevice});
+			JoystickReporter::instance().addJoystick((Joystick*)inputDevice);
 			break;
 		case InputDeviceTypeEnum::Keyboard:
 			m_keyboards.insert({name, inputDevice});
@@ -319,6 +410,7 @@ void InputManager::removeInputDevice(const string& name)
 				break;
 			case InputDeviceTypeEnum::Joystick:
 				m_joysticks.erase(inputDevice->name);
+				JoystickReporter::instance().removeJoystick(inputDevice->name);
 				break;
 			case InputDeviceTypeEnum::Keyboard:
 				m_keyboards.erase(inputDevice->name);
@@ -9,6 +9,7 @@
 #include "inputpoll/inputpoller.h"
 #include "input.h"
 #include "baseinputdevice.h"
+#include "devicecache.h"
 
 using namespace std;
 
@@ -46,6 +47,10 @@ public:
 	bool isDeviceTypeAllowed(InputDeviceTypeEnum type);
 
 	BaseInputDevice* resolveDevice(const string& name);
+	bool probeCapabilities(const string& name, DeviceCapabilities& capabilities);
+
+protected:
+	static BaseInputDevice* createDevice(InputDeviceTypeEnum type, const string& name, const string& path);
 
 protected:
 	void addInputDevice(BaseInputDevice* device);
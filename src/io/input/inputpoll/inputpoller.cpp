@@ -2,15 +2,20 @@
 
 #include "../../../common/logger/logger.h"
 
+#include <errno.h>
 #include <fcntl.h>
+#include <string.h>
 #include <sys/epoll.h>
+#include <sys/ioctl.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <linux/input.h>
 #include "../../../3rdparty/tinyformat/tinyformat.h"
+#include "../../../common/diagnostics/latencytracer.h"
 #include "../../../common/helpers/collectionhelper.h"
 #include "../input.h"
 #include "../baseinputdevice.h"
+#include "../joystickreporter.h"
 
 using namespace std;
 
@@ -63,6 +68,7 @@ void InputPoller::dispose()
 	if (m_eventsBuffer != nullptr)
 	{
 		free(m_eventsBuffer);
+		m_eventsBuffer = nullptr;
 	}
 }
 
@@ -72,70 +78,101 @@ void InputPoller::addInputDevice(InputDevice& device)
 
 	int fd = open(path.c_str(), O_RDWR | O_NOCTTY | O_NDELAY | O_NONBLOCK);
 
-	if (fd != INVALID_FILE_DESCRIPTOR)
+	if (fd == INVALID_FILE_DESCRIPTOR)
+	{
+		LOGERROR("%s: unable to open device '%s' for polling", __PRETTY_FUNCTION__, path.c_str());
+		return;
+	}
+
+	if (fd >= MAX_POLLED_FD)
+	{
+		LOGERROR("%s: fd=%d for '%s' exceeds device table size (%d)", __PRETTY_FUNCTION__, fd, device.model.c_str(), MAX_POLLED_FD);
+
+		close(fd);
+		return;
+	}
+
+	// Request event timestamps in CLOCK_MONOTONIC (realtime clock by default), so latency can be measured
+	int clockID = CLOCK_MONOTONIC;
+	if (ioctl(fd, EVIOCSCLOCKID, &clockID) < 0)
+	{
+		LOGWARN("%s: unable to switch '%s' to monotonic clock. Latency won't be traced for the device", __PRETTY_FUNCTION__, device.model.c_str());
+	}
+
+	// Descriptor is never modified after publishing
+	InputDevice* descriptor = new InputDevice(device);
+	descriptor->fd = fd;
+
 	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexDevices);
+
+		// Publish before registering in epoll, so the first event already finds the descriptor
+		m_devices[fd].store(descriptor);
+		m_deviceCount++;
+
 		epoll_event event;
-		event.data.fd = fd;
+		event.data.ptr = descriptor;
 		event.events = EPOLLIN | EPOLLET;
 
 		int res = epoll_ctl(m_fd_epoll, EPOLL_CTL_ADD, fd, &event);
 		if (res != -1)
 		{
-			// Lock parallel threads to access (active till return from method and lock destruction)
-			lock_guard<mutex> lock(m_mutexPoll);
-
-			m_devices.insert({fd, device});
-
 			DEBUG("%s: added '%s'", __PRETTY_FUNCTION__, device.model.c_str());
+			return;
 		}
-		else
-		{
-			LOGERROR("%s: unable to add device to epoll '%s'", __PRETTY_FUNCTION__, device.model.c_str());
 
-			close(fd);
-		}
-	}
-	else
-	{
-		LOGERROR("%s: unable to open device '%s' for polling", __PRETTY_FUNCTION__, path.c_str());
+		m_devices[fd].store(nullptr);
+		m_deviceCount--;
 	}
+
+	LOGERROR("%s: unable to add device to epoll '%s'", __PRETTY_FUNCTION__, device.model.c_str());
+
+	delete descriptor;
+	close(fd);
 }
 
+// Device is resolved by name: poller opens its own descriptor, so <device>.fd doesn't correspond to the polled one
 void InputPoller::removeInputDevice(InputDevice& device)
 {
 	// Lock parallel threads to access (active till return from method and lock destruction)
-	lock_guard<mutex> lock(m_mutexPoll);
+	lock_guard<mutex> lock(m_mutexDevices);
 
-	int fd = device.fd;
-	removeInputDeviceNoLock(fd);
+	for (int fd = 0; fd < MAX_POLLED_FD; fd++)
+	{
+		const InputDevice* descriptor = m_devices[fd].load();
+		if (descriptor != nullptr && descriptor->name == device.name)
+		{
+			removeInputDeviceNoLock(fd);
+			return;
+		}
+	}
 
-	// Remove from the device map
-	m_devices.erase(fd);
+	LOGWARN("%s: unable to find registered device '%s'", __PRETTY_FUNCTION__, device.name.c_str());
 }
 
 void InputPoller::removeInputDevice(int fd)
 {
 	// Lock parallel threads to access (active till return from method and lock destruction)
-	lock_guard<mutex> lock(m_mutexPoll);
+	lock_guard<mutex> lock(m_mutexDevices);
 
 	removeInputDeviceNoLock(fd);
-
-	// Remove from the device map
-	m_devices.erase(fd);
 }
 
 void InputPoller::removeInputDeviceNoLock(int fd)
 {
-	if (fd != INVALID_FILE_DESCRIPTOR)
+	if (fd != INVALID_FILE_DESCRIPTOR && fd < MAX_POLLED_FD)
 	{
-		if (key_exists(m_devices, fd))
+		const InputDevice* descriptor = m_devices[fd].exchange(nullptr);
+		if (descriptor != nullptr)
 		{
-			// Exclude from epoll processing
+			m_deviceCount--;
+
+			// Exclude from epoll processing. Descriptor is closed when poller is guaranteed to not use it anymore
 			struct epoll_event event;
 			epoll_ctl(m_fd_epoll, EPOLL_CTL_DEL, fd, &event);
 
-			// Close descriptor itself
-			close(fd);
+			retireDevice(descriptor);
 		}
 		else
 		{
@@ -150,21 +187,114 @@ void InputPoller::removeInputDeviceNoLock(int fd)
 
 void InputPoller::reset()
 {
-	// Lock parallel threads to access (active till return from method and lock destruction)
-	lock_guard<mutex> lock(m_mutexPoll);
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexDevices);
+
+		for (int fd = 0; fd < MAX_POLLED_FD; fd++)
+		{
+			if (m_devices[fd].load() != nullptr)
+			{
+				removeInputDeviceNoLock(fd);
+			}
+		}
+	}
 
-	for (auto it = m_devices.begin(); it != m_devices.end(); it++)
+	// Running poller reclaims retired descriptors itself (per-device poller state is accessed from poller thread only)
+	if (m_stopped)
 	{
-		int fd = it->first;
+		reclaimDevices(true);
+	}
+}
+
+// Enable direct in-game route to <core> adapter (nullptr - everything goes via MessageCenter)
+// Switch is applied by poller thread on the next packet
+void InputPoller::setDirectCore(ICoreInterface* core)
+{
+	ICoreInterface* previous = m_directCore.exchange(core);
 
-		removeInputDeviceNoLock(fd);
+	if (previous != core)
+	{
+		LOGINFO("Direct input route %s", core != nullptr ? "enabled" : "disabled");
 	}
+}
+
+void InputPoller::setHotkeys(const KeyBitset& hotkeys, const KeyBitset& reserved)
+{
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexHotkeys);
+
+	m_hotkeys = hotkeys;
+	m_reservedKeys = reserved;
+}
+
+InputPollerStatistics InputPoller::getStatistics()
+{
+	InputPollerStatistics result;
+
+	result.eventsRead = m_eventsRead;
+	result.packetsPosted = m_packetsPosted;
+	result.overflows = m_overflows;
+	result.eventsDropped = m_eventsDropped;
 
-	// Clear the whole devices map
-	m_devices.clear();
+	return result;
 }
 
 // Helper methods
+void InputPoller::retireDevice(const InputDevice* device)
+{
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexRetired);
+
+		m_retired.push_back({ m_pollEpoch.load(), device });
+	}
+
+	// No poller thread running - nobody can reference descriptor
+	if (m_stopped)
+	{
+		reclaimDevices(true);
+	}
+}
+
+// Close and free descriptors retired before the current poll iteration started (or all of them if <force>)
+// Poller thread never waits here: if writer holds the list - reclaim is postponed till the next iteration
+void InputPoller::reclaimDevices(bool force)
+{
+	unique_lock<mutex> lock(m_mutexRetired, defer_lock);
+	if (force)
+	{
+		lock.lock();
+	}
+	else if (!lock.try_lock())
+	{
+		return;
+	}
+
+	uint32_t epoch = m_pollEpoch;
+
+	for (auto it = m_retired.begin(); it != m_retired.end();)
+	{
+		if (force || it->first != epoch)
+		{
+			const InputDevice* device = it->second;
+
+			m_overflowed.erase(device->fd);
+			m_keyStates.erase(device->fd);
+			m_mouseButtons.erase(device->fd);
+
+			close(device->fd);
+			delete device;
+
+			it = m_retired.erase(it);
+		}
+		else
+		{
+			it++;
+		}
+	}
+}
+
 void InputPoller::makeNonBlocking(int fd)
 {
 	if (fd == INVALID_FILE_DESCRIPTOR)
@@ -191,11 +321,12 @@ int InputPoller::checkEvents()
 {
 	int result = 0;
 
-	// Lock parallel threads to access (active till return from method and lock destruction)
-	lock_guard<mutex> lock(m_mutexPoll);
+	// New iteration: nothing from previous epoll batch is referenced anymore
+	m_pollEpoch++;
+	reclaimDevices(false);
 
 	// Check if no devices registered - no sense to poll at all
-	if (m_devices.empty())
+	if (m_deviceCount == 0)
 	{
 		// Make same sleep to offload CPU
 		usleep(pollingInterval * 1000);
@@ -208,22 +339,26 @@ int InputPoller::checkEvents()
 	if (eventNum > 0)
 	{
 		result = eventNum;
+		m_wakeupTimestamp = LatencyTracer::instance().isEnabled() ? LatencyTracer::now() : 0;
 
 		for (int i = 0; i < eventNum; i++)
 		{
 			epoll_event& event = m_eventsBuffer[i];
+			const InputDevice* device = (const InputDevice*)event.data.ptr;
+
 			if (event.events & EPOLLERR)
 			{
-				int fd = event.data.fd;
-
-				LOGWARN("%s: fd=0x%x reported error during epoll", __PRETTY_FUNCTION__, fd);
+				LOGWARN("%s: fd=0x%x reported error during epoll", __PRETTY_FUNCTION__, device->fd);
 			}
 
-			int fd = event.data.fd;
-			readEvents(fd);
+			// Device removed while epoll batch was collected
+			if (m_devices[device->fd].load() != device)
+				continue;
+
+			readEvents(*device);
 		}
 	}
-	else if (eventNum == -1)
+	else if (eventNum == -1 && errno != EINTR)
 	{
 		LOGERROR("%s: %s", __PRETTY_FUNCTION__, logger::geterror());
 	}
@@ -231,15 +366,19 @@ int InputPoller::checkEvents()
 	return result;
 }
 
-void InputPoller::readEvents(int fd)
+void InputPoller::readEvents(const InputDevice& device)
 {
 	input_event events[MAX_INPUT_EVENTS];
 
+	int fd = device.fd;
 	int len = read(fd, &events, sizeof(events));
 
 	if (len > 0)
 	{
 		unsigned eventsCount = len / sizeof(input_event);
+		m_eventsRead += eventsCount;
+
+		KeyBitset& keys = m_keyStates[fd];
 
 		//TRACE("%s: received: %d raw events", __PRETTY_FUNCTION__, eventsCount);
 
@@ -253,13 +392,45 @@ void InputPoller::readEvents(int fd)
 			{
 				input_event& event = events[idx];
 
+				// Kernel buffer overflow: current packet is incomplete, skip everything till the next SYN_REPORT
+				if (event.type == EV_SYN && event.code == SYN_DROPPED)
+				{
+					LOGWARN("%s: fd=0x%x events buffer overflow (SYN_DROPPED)", __PRETTY_FUNCTION__, fd);
+
+					m_overflows++;
+					m_overflowed.insert(fd);
+				}
+
+				if (m_overflowed.count(fd) > 0)
+				{
+					if (event.type == EV_SYN && event.code == SYN_REPORT)
+					{
+						m_overflowed.erase(fd);
+
+						resyncDevice(device);
+					}
+					else
+					{
+						m_eventsDropped++;
+					}
+
+					packetStartIdx = idx + 1;
+					continue;
+				}
+
+				// Autorepeat (value 2) doesn't change the state
+				if (event.type == EV_KEY && event.value <= 1)
+				{
+					keys.set(event.code, event.value != 0);
+				}
+
 				// Determine end of packet
 				if (event.type == EV_SYN && event.code == SYN_REPORT)
 				{
 					int packetLen = idx - packetStartIdx;
 					if (packetLen > 0)
 					{
-						translateEvents(fd, &events[packetStartIdx], (unsigned)packetLen);
+						translateEvents(device, &events[packetStartIdx], (unsigned)packetLen);
 					}
 
 					packetStartIdx = idx + 1;
@@ -270,7 +441,7 @@ void InputPoller::readEvents(int fd)
 					int packetLen = idx - packetStartIdx;
 					if (packetLen > 0)
 					{
-						translateEvents(fd, &events[packetStartIdx], (unsigned)packetLen);
+						translateEvents(device, &events[packetStartIdx], (unsigned)packetLen);
 					}
 				}
 			}
@@ -278,31 +449,110 @@ void InputPoller::readEvents(int fd)
 	}
 }
 
-// Translate single logical event from device into higher level messages
-void InputPoller::translateEvents(int fd, input_event* events, unsigned numEvents)
+// Events between SYN_DROPPED and the next SYN_REPORT are lost. Current device state is queried and differences
+// are delivered as a synthetic packet, so no key / button stays stuck and axes return to their actual position.
+// Synthetic events have zero timestamp (not counted by latency tracing)
+void InputPoller::resyncDevice(const InputDevice& device)
 {
-	if (events == nullptr || numEvents == 0)
+	int fd = device.fd;
+	vector<input_event> events;
+
+	input_event event;
+	memset(&event, 0, sizeof(event));
+
+	// Keys (including mouse / joystick buttons): only transitions are synthesized
+	KeyBitset& keys = m_keyStates[fd];
+	KeyBitset current;
+	if (ioctl(fd, EVIOCGKEY(sizeof(current.words)), current.words) >= 0)
 	{
-		LOGWARN("%s: invalid parameters supplied", __PRETTY_FUNCTION__);
-		return;
+		for (unsigned word = 0; word < KEYBITSET_WORDS; word++)
+		{
+			uint32_t changed = current.words[word] ^ keys.words[word];
+			for (unsigned bit = 0; changed != 0; bit++, changed >>= 1)
+			{
+				if (changed & 1)
+				{
+					event.type = EV_KEY;
+					event.code = word * KEYBITSET_BITS_PER_WORD + bit;
+					event.value = current.test(event.code) ? 1 : 0;
+					events.push_back(event);
+				}
+			}
+		}
+
+		keys = current;
 	}
 
-	// Check if descriptor is registered
-	if (!key_exists(m_devices, fd))
+	// Absolute axes: current values are sent as is (repeated values don't change the state)
+	BitType absBits[BITFIELD_LONGS_PER_ARRAY(ABS_CNT)] = { 0 };
+	if (device.type == +InputDeviceTypeEnum::Joystick && ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits) >= 0)
 	{
-		LOGWARN("%s: unknown device fd: 0x%x. No notifications will be created.", __PRETTY_FUNCTION__, fd);
+		for (uint16_t code = 0; code < ABS_CNT; code++)
+		{
+			input_absinfo info;
+			if (BITFIELD_TEST(code, absBits) && ioctl(fd, EVIOCGABS(code), &info) >= 0)
+			{
+				event.type = EV_ABS;
+				event.code = code;
+				event.value = info.value;
+				events.push_back(event);
+			}
+		}
+	}
+
+	LOGWARN("%s: fd=0x%x state re-synchronized after overflow (%zu event(s) synthesized)", __PRETTY_FUNCTION__, fd, events.size());
+
+	if (!events.empty())
+	{
+		translateEvents(device, events.data(), (unsigned)events.size());
+	}
+}
+
+// Translate single logical event from device into higher level messages
+void InputPoller::translateEvents(const InputDevice& device, input_event* events, unsigned numEvents)
+{
+	if (events == nullptr || numEvents == 0)
+	{
+		LOGWARN("%s: invalid parameters supplied", __PRETTY_FUNCTION__);
 		return;
 	}
 
-	// Resolve device type from descriptor
-	InputDevice& device = m_devices[fd];
+	int fd = device.fd;
 	InputDeviceTypeEnum deviceType = device.type;
-	string name = device.name;
+	const string& name = device.name;
 
 	//TRACE("Device %s:'%s' received %d event(s), EV_SYN excluded", device.dumpDeviceType().c_str(), device.model.c_str(), numEvents);
 
 	//TRACE(dumpEPollEvents(events, numEvents).c_str());
 
+	// Latency from kernel event timestamp till poller wakeup
+	LatencyTracer& tracer = LatencyTracer::instance();
+	uint64_t timestamp = LatencyTracer::toMicroseconds(events[0].time);
+	tracer.record(name, LatencyStageEnum::Wakeup, timestamp, m_wakeupTimestamp);
+
+	// Route switched (menu shown / core changed) - release everything previous core still considers pressed
+	ICoreInterface* core = m_directCore.load();
+	if (core != m_routedCore)
+	{
+		releaseRoutedKeys();
+		m_routedCore = core;
+	}
+
+	// In-game: keyboard and mouse go straight to the core adapter
+	if (core != nullptr)
+	{
+		if (deviceType == +InputDeviceTypeEnum::Keyboard)
+		{
+			routeKeyboard(core, fd, name, events, numEvents);
+			return;
+		}
+		else if (deviceType == +InputDeviceTypeEnum::Mouse)
+		{
+			routeMouse(core, fd, name, events, numEvents);
+			return;
+		}
+	}
+
 	string topic;
 	MessagePayloadBase* payload = nullptr;
 
@@ -326,10 +576,20 @@ void InputPoller::translateEvents(int fd, input_event* events, unsigned numEvent
 			break;
 		case InputDeviceTypeEnum::Joystick:
 			{
-				topic = EVENT_JOYSTICK;
 				MInputMessage* event = new MInputMessage();
 				createJoystickEvent(event, fd, name, events, numEvents);
-				payload = event;
+
+				// Joystick state is accumulated and reported to the core once per frame by JoystickReporter.
+				// Only packets with button changes are broadcast (axis-only packets would just flood the queue)
+				if (JoystickReporter::instance().update(*event))
+				{
+					topic = EVENT_JOYSTICK;
+					payload = event;
+				}
+				else
+				{
+					delete event;
+				}
 			}
 			break;
 		default:
@@ -342,14 +602,167 @@ void InputPoller::translateEvents(int fd, input_event* events, unsigned numEvent
 	{
 		MessageCenter& center = MessageCenter::defaultCenter();
 		center.post(topic, this, payload);
+		m_packetsPosted++;
+
+		tracer.record(name, LatencyStageEnum::Post, timestamp);
+	}
+}
+
+// Send key transitions directly to the core. Hotkeys are still broadcast to CommandCenter
+// (reserved ones exclusively, the rest - both ways). Autorepeat (value 2) is handled by cores themselves
+void InputPoller::routeKeyboard(ICoreInterface* core, int fd, const string& name, input_event* events, unsigned numEvents)
+{
+	input_event hotkeyEvents[MAX_INPUT_EVENTS];
+	unsigned hotkeyCount = 0;
+
+	// Sets are copied, so the lock isn't held while the core handles keys
+	KeyBitset hotkeys;
+	KeyBitset reservedKeys;
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexHotkeys);
+
+		hotkeys = m_hotkeys;
+		reservedKeys = m_reservedKeys;
+	}
+
+	for (unsigned i = 0; i < numEvents; i++)
+	{
+		input_event& event = events[i];
+		if (event.type != EV_KEY || event.value > 1)
+			continue;
+
+		uint16_t key = event.code;
+		bool pressed = event.value != 0;
+
+		if (hotkeys.test(key) && hotkeyCount < MAX_INPUT_EVENTS)
+		{
+			hotkeyEvents[hotkeyCount++] = event;
+		}
+
+		if (!reservedKeys.test(key))
+		{
+			// Release is always delivered if key was reported as pressed, even if it became reserved since then
+			if (pressed || m_routedKeys.test(key))
+			{
+				core->translateKeypress(key, pressed);
+				m_routedKeys.set(key, pressed);
+			}
+		}
+		else if (!pressed && m_routedKeys.test(key))
+		{
+			core->translateKeypress(key, false);
+			m_routedKeys.set(key, false);
+		}
+	}
+
+	LatencyTracer& tracer = LatencyTracer::instance();
+	uint64_t timestamp = LatencyTracer::toMicroseconds(events[0].time);
+	tracer.record(name, LatencyStageEnum::Transfer, timestamp);
+
+	if (hotkeyCount > 0)
+	{
+		MInputMessage* message = new MInputMessage();
+		createKeyboardEvent(message, fd, name, hotkeyEvents, hotkeyCount);
+
+		MessageCenter& center = MessageCenter::defaultCenter();
+		center.post(EVENT_KEYBOARD, this, message);
+		m_packetsPosted++;
+
+		tracer.record(name, LatencyStageEnum::Post, timestamp);
+	}
+}
+
+// Accumulate packet movement / buttons and pass them to the core with a single call
+void InputPoller::routeMouse(ICoreInterface* core, int fd, const string& name, input_event* events, unsigned numEvents)
+{
+	int32_t deltaX = 0;
+	int32_t deltaY = 0;
+	uint8_t& buttons = m_mouseButtons[fd];
+	uint8_t previousButtons = buttons;
+
+	for (unsigned i = 0; i < numEvents; i++)
+	{
+		input_event& event = events[i];
+
+		if (event.type == EV_REL)
+		{
+			if (event.code == REL_X)
+				deltaX += event.value;
+			else if (event.code == REL_Y)
+				deltaY += event.value;
+		}
+		else if (event.type == EV_KEY)
+		{
+			uint8_t mask = 0;
+			switch (event.code)
+			{
+				case BTN_LEFT:
+					mask = 0x01;
+					break;
+				case BTN_RIGHT:
+					mask = 0x02;
+					break;
+				case BTN_MIDDLE:
+					mask = 0x04;
+					break;
+				default:
+					break;
+			}
+
+			buttons = event.value ? buttons | mask : buttons & ~mask;
+		}
+	}
+
+	if (deltaX != 0 || deltaY != 0 || buttons != previousButtons)
+	{
+		deltaX = deltaX > INT16_MAX ? INT16_MAX : (deltaX < INT16_MIN ? INT16_MIN : deltaX);
+		deltaY = deltaY > INT16_MAX ? INT16_MAX : (deltaY < INT16_MIN ? INT16_MIN : deltaY);
+
+		core->translateMouseCoordinates((int16_t)deltaX, (int16_t)deltaY, buttons);
+
+		uint64_t timestamp = LatencyTracer::toMicroseconds(events[0].time);
+		LatencyTracer::instance().record(name, LatencyStageEnum::Transfer, timestamp);
 	}
 }
 
+// Release all keys previous core still considers pressed (called on route switch, poller thread only)
+void InputPoller::releaseRoutedKeys()
+{
+	if (m_routedCore != nullptr)
+	{
+		for (unsigned word = 0; word < KEYBITSET_WORDS; word++)
+		{
+			uint32_t bits = m_routedKeys.words[word];
+			for (unsigned bit = 0; bits != 0; bit++, bits >>= 1)
+			{
+				if (bits & 1)
+				{
+					m_routedCore->translateKeypress(word * KEYBITSET_BITS_PER_WORD + bit, false);
+				}
+			}
+		}
+
+		for (auto& item : m_mouseButtons)
+		{
+			if (item.second != 0)
+			{
+				m_routedCore->translateMouseCoordinates(0, 0, 0);
+				break;
+			}
+		}
+	}
+
+	m_routedKeys.clear();
+	m_mouseButtons.clear();
+}
+
 void InputPoller::createMouseEvent(MInputMessage* message, int fd, const string& name, input_event* events, unsigned numEvents)
 {
 	message->deviceID = fd;
 	message->name = name;
 	message->deviceType = InputDeviceTypeEnum::Mouse;
+	message->timestamp = LatencyTracer::toMicroseconds(events[0].time);
 
 	uint16_t code;
 	int32_t value;
@@ -414,6 +827,7 @@ void InputPoller::createKeyboardEvent(MInputMessage* message, int fd, const stri
 	message->deviceID = fd;
 	message->name = name;
 	message->deviceType = InputDeviceTypeEnum::Keyboard;
+	message->timestamp = LatencyTracer::toMicroseconds(events[0].time);
 
 	uint16_t code;
 	int32_t value;
@@ -454,6 +868,7 @@ void InputPoller::createJoystickEvent(MInputMessage* message, int fd, const stri
 	message->deviceID = fd;
 	message->name = name;
 	message->deviceType = InputDeviceTypeEnum::Joystick;
+	message->timestamp = LatencyTracer::toMicroseconds(events[0].time);
 
 	uint16_t code;
 	int32_t value;
@@ -472,7 +887,9 @@ void InputPoller::createJoystickEvent(MInputMessage* message, int fd, const stri
 					MInputEvent absoluteMoveEvent;
 					absoluteMoveEvent.deviceID = fd;
 					absoluteMoveEvent.type = AbsoluteMove;
-					//absoluteMoveEvent.event.absoluteMoveEvent;
+					absoluteMoveEvent.event.absoluteMoveEvent.axis = code;
+					absoluteMoveEvent.event.absoluteMoveEvent.value = value;
+					message->events.push_back(absoluteMoveEvent);
 				}
 				break;
 			case EV_KEY:
@@ -568,6 +985,12 @@ void InputPoller::run()
 		{
 			eventsCount += checkEvents();
 
+			// Report accumulated joystick state (no-op if less than a frame passed since the last report)
+			JoystickReporter::instance().flush();
+
+			// Publish input latency histograms periodically
+			LatencyTracer::instance().reportIfDue();
+
 			eventsCount++;
 		}
 		catch (const exception& e)
@@ -585,6 +1008,9 @@ void InputPoller::run()
 		// No need for additional sleep loop. checkEvents() already has embedded timeout in epoll_wait
 	}
 
+	// Final latency report for the session
+	LatencyTracer::instance().report();
+
 	LOGINFO("InputPoller: thread with tid: %d (0x%x) loop stopped]\n    Loop iterations passed: %d", m_thread_id, m_thread_id, loopIterationsCount);
 }
 
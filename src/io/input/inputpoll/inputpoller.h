@@ -1,30 +1,77 @@
 #ifndef IO_INPUT_INPUTPOLL_INPUTPOLLER_H_
 #define IO_INPUT_INPUTPOLL_INPUTPOLLER_H_
 
+#include <atomic>
 #include <map>
 #include <mutex>
+#include <set>
+#include <vector>
 #include "../../../common/consts.h"
 #include "../../../common/types.h"
 #include "../../../common/messagetypes.h"
 #include "../../../common/events/events.h"
 #include "../../../common/events/messagecenter.h"
 #include "../../../common/thread/runnable.h"
+#include "../../../interfaces/icoreinterface.h"
 #include "../input.h"
+#include "../keybitset.h"
 
 typedef struct input_event input_event;
 typedef struct epoll_event epoll_event;
-typedef map<int, InputDevice> EPollMap;
+typedef pair<uint32_t, const InputDevice*> RetiredDevice;
+
+// Poller throughput counters (monotonically increasing since start)
+struct InputPollerStatistics
+{
+	uint64_t eventsRead = 0;		// Raw input_event records read from devices
+	uint64_t packetsPosted = 0;		// Messages broadcast via MessageCenter
+	uint64_t overflows = 0;			// SYN_DROPPED received (kernel evdev buffer overflow)
+	uint64_t eventsDropped = 0;		// Records discarded due to overflow (till the next SYN_REPORT)
+};
+typedef struct InputPollerStatistics InputPollerStatistics;
 
 class InputPoller : public Runnable, EventSource
 {
 protected:
 	atomic<bool> m_initialized;
-	mutex m_mutexPoll;
 
-	EPollMap m_devices;
+	// Device table: fd-indexed immutable descriptors, published with atomic pointer swaps.
+	// Poller thread never takes locks to access it (descriptor also comes back via epoll_event.data.ptr)
+	atomic<const InputDevice*> m_devices[MAX_POLLED_FD];
+	atomic<unsigned> m_deviceCount { 0 };
+	mutex m_mutexDevices;		// Serializes writers (hotplug) only
+
+	// Removed descriptors (and their fds) are released only when poller moved to the next iteration,
+	// so epoll results already collected never point to freed memory or reused fd
+	mutex m_mutexRetired;
+	vector<RetiredDevice> m_retired;
+	atomic<uint32_t> m_pollEpoch { 0 };
+
 	int m_fd_epoll = INVALID_FILE_DESCRIPTOR;
 	epoll_event* m_eventsBuffer = nullptr;
 
+	// Time when last epoll_wait returned with events (for latency tracing)
+	uint64_t m_wakeupTimestamp = 0;
+
+	// Devices reported SYN_DROPPED, their events are discarded till the next SYN_REPORT (then state is re-synchronized)
+	set<int> m_overflowed;
+	map<int, KeyBitset> m_keyStates;			// Keys state per device as delivered so far (to restore transitions lost in overflow)
+
+	atomic<uint64_t> m_eventsRead { 0 };
+	atomic<uint64_t> m_packetsPosted { 0 };
+	atomic<uint64_t> m_overflows { 0 };
+	atomic<uint64_t> m_eventsDropped { 0 };
+
+	// Direct in-game route: keyboard / mouse packets are translated into core calls right on the poller thread
+	// (no MessageCenter queue hop). Active only while set, i.e. while no menu is shown
+	atomic<ICoreInterface*> m_directCore { nullptr };
+	ICoreInterface* m_routedCore = nullptr;		// Core used by the last routed packet (poller thread only)
+	KeyBitset m_routedKeys;						// Keys reported as pressed to m_routedCore
+	mutex m_mutexHotkeys;
+	KeyBitset m_hotkeys;						// Keys still broadcast via MessageCenter (OSD / emulation hotkeys)
+	KeyBitset m_reservedKeys;					// Hotkeys that must never reach the core
+	map<int, uint8_t> m_mouseButtons;			// Mouse buttons state per device
+
 public:
 	// Latency is important for fast input events reaction
 	int pollingInterval = 2; // 2ms
@@ -47,18 +94,30 @@ public:
 	void removeInputDevice(int fd);
 	void reset();
 
+	InputPollerStatistics getStatistics();
+
+	void setDirectCore(ICoreInterface* core);
+	void setHotkeys(const KeyBitset& hotkeys, const KeyBitset& reserved);
+
 // Helper methods
 protected:
 	void makeNonBlocking(int fd);
 	int checkEvents();
-	void readEvents(int fd);
-	void translateEvents(int fd, input_event* events, unsigned numEvents);
+	void readEvents(const InputDevice& device);
+	void resyncDevice(const InputDevice& device);
+	void translateEvents(const InputDevice& device, input_event* events, unsigned numEvents);
 
 	void createMouseEvent(MInputMessage* message, int fd, const string& name, input_event* events, unsigned numEvents);
 	void createKeyboardEvent(MInputMessage* message, int fd, const string& name, input_event* events, unsigned numEvents);
 	void createJoystickEvent(MInputMessage* message, int fd, const string& name, input_event* events, unsigned numEvents);
 
 	void removeInputDeviceNoLock(int fd);
+	void retireDevice(const InputDevice* device);
+	void reclaimDevices(bool force);
+
+	void routeKeyboard(ICoreInterface* core, int fd, const string& name, input_event* events, unsigned numEvents);
+	void routeMouse(ICoreInterface* core, int fd, const string& name, input_event* events, unsigned numEvents);
+	void releaseRoutedKeys();
 
 	// Debug
 	string dumpEPollEvents(input_event* events, unsigned numEvents);
@@ -73,6 +132,11 @@ private:
 	{
 		m_name = name;
 		m_initialized = false;
+
+		for (auto& slot : m_devices)
+		{
+			slot = nullptr;
+		}
 	}
 };
 
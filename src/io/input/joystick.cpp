@@ -1,7 +1,190 @@
 #include "joystick.h"
 
+#include "../../common/logger/logger.h"
+
+#include <string.h>
+#include <sys/ioctl.h>
+#include "../../fpga/fpgacommand.h"
+#include "devicecache.h"
+
 Joystick::Joystick(const string& name, const string& path) : BaseInputDevice(name, path)
 {
+	memset(m_axisSlots, -1, sizeof(m_axisSlots));
+}
+
+bool Joystick::init()
+{
+	bool result = BaseInputDevice::init();
+
+	// Retrieve analog axes ranges
+	queryAxes();
+
+	return result;
 }
 
+// Restore axes layout and ranges from cache instead of EVIOCGBIT / EVIOCGABS queries
+bool Joystick::initFromCache(const DeviceCapabilities& capabilities)
+{
+	bool result = BaseInputDevice::initFromCache(capabilities);
+
+	memset(m_axisSlots, -1, sizeof(m_axisSlots));
+	m_axisCount = 0;
+
+	for (unsigned i = 0; i < capabilities.axisCount && i < JOYSTICK_MAX_AXES; i++)
+	{
+		uint16_t code = capabilities.axisCodes[i];
+		if (code >= ABS_CNT)
+			continue;
+
+		m_calibrations[m_axisCount] = capabilities.calibrations[i];
+		m_axisSlots[code] = m_axisCount++;
+	}
+
+	return result;
+}
+
+void Joystick::getCapabilities(DeviceCapabilities& capabilities)
+{
+	BaseInputDevice::getCapabilities(capabilities);
 
+	// Axis slots are assigned in EV_ABS code order, so the list is restored in the same order
+	for (uint16_t code = 0; code < ABS_CNT; code++)
+	{
+		int8_t slot = m_axisSlots[code];
+		if (slot < 0 || slot >= JOYSTICK_MAX_AXES)
+			continue;
+
+		capabilities.axisCodes[slot] = code;
+		capabilities.calibrations[slot] = m_calibrations[slot];
+	}
+
+	capabilities.axisCount = m_axisCount;
+}
+
+uint8_t Joystick::getAxisCount()
+{
+	return m_axisCount;
+}
+
+int8_t Joystick::getAxisSlot(uint16_t code)
+{
+	int8_t result = -1;
+
+	if (code < ABS_CNT)
+	{
+		result = m_axisSlots[code];
+	}
+
+	return result;
+}
+
+const int8_t* Joystick::getAxisSlots()
+{
+	return m_axisSlots;
+}
+
+const AxisCalibration* Joystick::getAxisCalibrations()
+{
+	return m_calibrations;
+}
+
+// Hats (D-pads reported as axes) produce only -1 / 0 / 1 values and treated as digital directions
+bool Joystick::isHatAxis(uint16_t code)
+{
+	bool result = code >= ABS_HAT0X && code <= ABS_HAT3Y;
+
+	return result;
+}
+
+// Map gamepad / joystick button code to core joystick bitmask (JOY_* constants)
+uint32_t Joystick::getButtonMask(uint16_t code)
+{
+	uint32_t result = 0;
+
+	switch (code)
+	{
+		case BTN_SOUTH:			result = JOY_A; break;
+		case BTN_EAST:			result = JOY_B; break;
+		case BTN_NORTH:			result = JOY_X; break;
+		case BTN_WEST:			result = JOY_Y; break;
+		case BTN_TL:				result = JOY_L; break;
+		case BTN_TR:				result = JOY_R; break;
+		case BTN_TL2:			result = JOY_L2; break;
+		case BTN_TR2:			result = JOY_R2; break;
+		case BTN_SELECT:			result = JOY_SELECT; break;
+		case BTN_START:			result = JOY_START; break;
+		case BTN_THUMBL:			result = JOY_L3; break;
+		case BTN_THUMBR:			result = JOY_R3; break;
+		case BTN_DPAD_UP:		result = JOY_UP; break;
+		case BTN_DPAD_DOWN:		result = JOY_DOWN; break;
+		case BTN_DPAD_LEFT:		result = JOY_LEFT; break;
+		case BTN_DPAD_RIGHT:		result = JOY_RIGHT; break;
+		default:
+			// Generic joysticks report BTN_TRIGGER, BTN_THUMB ... BTN_BASE6. Map them sequentially starting from JOY_BTN1
+			if (code >= BTN_JOYSTICK && code < BTN_JOYSTICK + 12)
+			{
+				result = JOY_BTN1 << (code - BTN_JOYSTICK);
+			}
+			break;
+	}
+
+	return result;
+}
+
+uint32_t Joystick::getHatMask(uint16_t code, int32_t value)
+{
+	uint32_t result = 0;
+
+	// Only first hat is used for directions
+	if (code == ABS_HAT0X)
+	{
+		result = value < 0 ? JOY_LEFT : value > 0 ? JOY_RIGHT : 0;
+	}
+	else if (code == ABS_HAT0Y)
+	{
+		result = value < 0 ? JOY_UP : value > 0 ? JOY_DOWN : 0;
+	}
+
+	return result;
+}
+
+// Helper methods
+
+// Query supported absolute axes with their ranges and assign axis slots in EV_ABS code order
+void Joystick::queryAxes()
+{
+	memset(bit_abs, 0, sizeof(bit_abs));
+	memset(m_axisSlots, -1, sizeof(m_axisSlots));
+	m_axisCount = 0;
+
+	if (!InputDeviceHelper::isDescriptorValid(fd))
+		return;
+
+	if (ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(bit_abs)), bit_abs) < 0)
+	{
+		LOGERROR("%s: unable to retrieve EV_ABS bits for device '%s'", __PRETTY_FUNCTION__, model.c_str());
+		return;
+	}
+
+	for (uint16_t code = 0; code < ABS_CNT && m_axisCount < JOYSTICK_MAX_AXES; code++)
+	{
+		if (!InputDeviceHelper::isBitSet(bit_abs, code) || isHatAxis(code))
+			continue;
+
+		struct input_absinfo absinfo;
+		if (ioctl(fd, EVIOCGABS(code), &absinfo) < 0)
+		{
+			LOGWARN("%s: unable to retrieve range for axis 0x%x", __PRETTY_FUNCTION__, code);
+			continue;
+		}
+
+		AxisCalibration& calibration = m_calibrations[m_axisCount];
+		calibration.minimum = absinfo.minimum;
+		calibration.maximum = absinfo.maximum;
+		calibration.flat = absinfo.flat;
+
+		m_axisSlots[code] = m_axisCount++;
+
+		TRACE("%s: axis 0x%x (%s) range [%d..%d], flat: %d", __PRETTY_FUNCTION__, code, dumpAbsType(code).c_str(), absinfo.minimum, absinfo.maximum, absinfo.flat);
+	}
+}
@@ -1,15 +1,44 @@
 #ifndef IO_INPUT_JOYSTICK_H_
 #define IO_INPUT_JOYSTICK_H_
 #include <string>
+#include <linux/input.h>
 #include "baseinputdevice.h"
+#include "analogprocessor.h"
 
 using namespace std;
 
 class Joystick: public BaseInputDevice
 {
+protected:
+	unsigned long bit_abs[BITFIELD_LONGS_PER_ARRAY(ABS_CNT)];
+
+	// Analog axes mapping: EV_ABS code => axis slot (-1 if axis is not supported or handled as digital)
+	int8_t m_axisSlots[ABS_CNT];
+	uint8_t m_axisCount = 0;
+
+	// Calibration for each axis slot (ranges are taken from EVIOCGABS during init)
+	AxisCalibration m_calibrations[JOYSTICK_MAX_AXES];
+
 public:
 	Joystick(const string& name, const string& path);
 	virtual ~Joystick() {};
+
+	bool init() override;
+	bool initFromCache(const DeviceCapabilities& capabilities) override;
+	void getCapabilities(DeviceCapabilities& capabilities) override;
+
+	// Axis information
+	uint8_t getAxisCount();
+	int8_t getAxisSlot(uint16_t code);
+	const int8_t* getAxisSlots();
+	const AxisCalibration* getAxisCalibrations();
+
+	static bool isHatAxis(uint16_t code);
+	static uint32_t getButtonMask(uint16_t code);
+	static uint32_t getHatMask(uint16_t code, int32_t value);
+
+protected:
+	void queryAxes();
 };
 
 #endif /* IO_INPUT_JOYSTICK_H_ */
@@ -0,0 +1,622 @@
+#include "joystickreporter.h"
+
+#include "../../common/logger/logger.h"
+
+#include <stdlib.h>
+#include "../../common/diagnostics/latencytracer.h"
+
+#include "../../common/timer/timerservice.h"
+#include "../../fpga/fpgadevice.h"
+#include "../../fpga/fpgacommand.h"
+
+JoystickReporter& JoystickReporter::instance()
+{
+	static JoystickReporter instance;
+
+	return instance;
+}
+
+JoystickReporter::JoystickReporter() : m_autofireTimer([this]() { onAutofireTick(); })
+{
+}
+
+// Assign joystick to the core <port> (-1 - first port without devices assigned)
+// Returns port index or -1 if all ports (or device slots) are occupied
+int JoystickReporter::addJoystick(Joystick* joystick, int port)
+{
+	int result = -1;
+
+	if (joystick == nullptr || port >= MAX_JOYSTICKS)
+		return result;
+
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexPads);
+
+	port = port < 0 ? findFreePort() : port;
+
+	for (int idx = 0; port >= 0 && idx < MAX_INPUT_DEVICES; idx++)
+	{
+		JoystickPad& pad = m_pads[idx];
+		if (pad.active)
+			continue;
+
+		pad = JoystickPad();
+		pad.active = true;
+		pad.name = joystick->name;
+		pad.port = port;
+		memcpy(pad.axisSlots, joystick->getAxisSlots(), sizeof(pad.axisSlots));
+		memcpy(pad.calibrations, joystick->getAxisCalibrations(), sizeof(pad.calibrations));
+		AnalogProcessor::prepare(pad.calibrations, joystick->getAxisCount(), pad.batch);
+
+		// Start from neutral position (raw center value produces 0 after processing)
+		for (int i = 0; i < JOYSTICK_MAX_AXES; i++)
+		{
+			pad.rawAxes[i] = pad.batch.center[i];
+		}
+
+		result = port;
+		break;
+	}
+
+	if (result >= 0)
+	{
+		LOGINFO("Joystick '%s' (%s) assigned to port %d", joystick->model.c_str(), joystick->name.c_str(), result);
+	}
+	else
+	{
+		LOGWARN("%s: no free ports available for joystick '%s'", __PRETTY_FUNCTION__, joystick->model.c_str());
+	}
+
+	return result;
+}
+
+void JoystickReporter::removeJoystick(const string& name)
+{
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexPads);
+
+	int idx = findPad(name);
+	if (idx >= 0)
+	{
+		JoystickPad& pad = m_pads[idx];
+
+		// Port state is re-aggregated without the device during next flush (releasing everything it held)
+		pad.active = false;
+		m_ports[pad.port].dirty = true;
+	}
+}
+
+// Move device to another core port. Both ports are re-sent during next flush
+bool JoystickReporter::setPort(const string& name, uint8_t port)
+{
+	bool result = false;
+
+	if (port >= MAX_JOYSTICKS)
+		return result;
+
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexPads);
+
+	int idx = findPad(name);
+	if (idx >= 0)
+	{
+		JoystickPad& pad = m_pads[idx];
+		m_ports[pad.port].dirty = true;
+		m_ports[port].dirty = true;
+		pad.port = port;
+
+		result = true;
+	}
+
+	return result;
+}
+
+void JoystickReporter::setAxisCalibration(const string& name, uint8_t slot, const AxisCalibration& calibration)
+{
+	if (slot >= JOYSTICK_MAX_AXES)
+		return;
+
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexPads);
+
+	int idx = findPad(name);
+	if (idx >= 0)
+	{
+		JoystickPad& pad = m_pads[idx];
+		pad.calibrations[slot] = calibration;
+		AnalogProcessor::prepare(pad.calibrations, JOYSTICK_MAX_AXES, pad.batch);
+		pad.dirty = true;
+	}
+}
+
+void JoystickReporter::reset()
+{
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexPads);
+
+	for (int idx = 0; idx < MAX_INPUT_DEVICES; idx++)
+	{
+		m_pads[idx] = JoystickPad();
+	}
+
+	for (int port = 0; port < MAX_JOYSTICKS; port++)
+	{
+		m_ports[port] = JoystickPort();
+	}
+}
+
+// Accumulate events from single device packet. No transfers to FPGA made here
+// Returns true if message contains button events (so it makes sense to broadcast it further)
+bool JoystickReporter::update(const MInputMessage& message)
+{
+	bool result = false;
+
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexPads);
+
+	int idx = findPad(message.name);
+	if (idx < 0)
+		return result;
+
+	JoystickPad& pad = m_pads[idx];
+
+	for (auto& ev : message.events)
+	{
+		switch (ev.type)
+		{
+			case InputEventTypeEnum::Key:
+				{
+					const KeyEvent& keyEvent = ev.event.keyEvent;
+					uint32_t mask = Joystick::getButtonMask(keyEvent.key);
+
+					pad.buttons = keyEvent.state ? pad.buttons | mask : pad.buttons & ~mask;
+
+					result = true;
+				}
+				break;
+			case InputEventTypeEnum::AbsoluteMove:
+				{
+					const AbsoluteMoveEvent& absEvent = ev.event.absoluteMoveEvent;
+
+					if (Joystick::isHatAxis(absEvent.axis))
+					{
+						uint32_t axisMask = absEvent.axis == ABS_HAT0X ? (JOY_LEFT | JOY_RIGHT) : (JOY_UP | JOY_DOWN);
+						pad.hatButtons = (pad.hatButtons & ~axisMask) | Joystick::getHatMask(absEvent.axis, absEvent.value);
+					}
+					else if (absEvent.axis < ABS_CNT && pad.axisSlots[absEvent.axis] >= 0)
+					{
+						pad.rawAxes[pad.axisSlots[absEvent.axis]] = absEvent.value;
+					}
+				}
+				break;
+			default:
+				break;
+		}
+	}
+
+	if (!pad.dirty)
+	{
+		pad.dirty = true;
+		pad.timestamp = message.timestamp;
+	}
+
+	return result;
+}
+
+// Send accumulated state for all changed ports. Intended to be called from the polling loop
+// Does nothing if less than JOYSTICK_REPORT_INTERVAL passed since previous report
+void JoystickReporter::flush()
+{
+	auto now = chrono::steady_clock::now();
+	if (now - m_lastReport < chrono::milliseconds(JOYSTICK_REPORT_INTERVAL))
+		return;
+
+	m_lastReport = now;
+
+	LatencyTracer& tracer = LatencyTracer::instance();
+
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexPads);
+
+	JoystickState states[MAX_JOYSTICKS];
+	uint8_t changed[MAX_JOYSTICKS];
+	unsigned changedCount = 0;
+	bool isReported[MAX_JOYSTICKS] = { false };		// Core side matches port state after this flush
+	bool isTransferred[MAX_JOYSTICKS] = { false };
+
+	for (uint8_t port = 0; port < MAX_JOYSTICKS; port++)
+	{
+		if (!isPortDirty(port))
+			continue;
+
+		states[port] = m_ports[port].muted ? JoystickState() : getPortState(port, true);
+
+		for (auto& pad : m_pads)
+		{
+			if (pad.active && pad.dirty && pad.port == port)
+			{
+				tracer.record(pad.name, LatencyStageEnum::Mapper, pad.timestamp);
+			}
+		}
+
+		const JoystickState& sent = m_ports[port].sent;
+		if (!states[port].isButtonsEqual(sent) || !states[port].isAxesEqual(sent))
+		{
+			changed[changedCount++] = port;
+		}
+		else
+		{
+			// Changes compensated each other (or affected only axes not reported to the core)
+			isReported[port] = true;
+		}
+	}
+
+	// Ports stay dirty if FPGA was busy, so state will be re-sent during next frame
+	if (changedCount > 0 && sendStates(changed, changedCount, states))
+	{
+		for (unsigned i = 0; i < changedCount; i++)
+		{
+			isReported[changed[i]] = true;
+			isTransferred[changed[i]] = true;
+		}
+	}
+
+	for (uint8_t port = 0; port < MAX_JOYSTICKS; port++)
+	{
+		if (isReported[port])
+		{
+			m_ports[port].dirty = false;
+		}
+	}
+
+	for (auto& pad : m_pads)
+	{
+		if (pad.active && pad.dirty && isReported[pad.port])
+		{
+			if (isTransferred[pad.port])
+			{
+				tracer.record(pad.name, LatencyStageEnum::Transfer, pad.timestamp);
+			}
+
+			pad.dirty = false;
+			pad.timestamp = 0;
+		}
+	}
+}
+
+JoystickState JoystickReporter::getState(uint8_t port)
+{
+	JoystickState result;
+
+	if (port < MAX_JOYSTICKS)
+	{
+		// Lock parallel threads to access (active till return from method and lock destruction)
+		lock_guard<mutex> lock(m_mutexPads);
+
+		result = m_ports[port].sent;
+	}
+
+	return result;
+}
+
+// Actual (not yet reported) state of the port, calculated from accumulated events
+JoystickState JoystickReporter::getInputState(uint8_t port)
+{
+	JoystickState result;
+
+	if (port < MAX_JOYSTICKS)
+	{
+		// Lock parallel threads to access (active till return from method and lock destruction)
+		lock_guard<mutex> lock(m_mutexPads);
+
+		result = getPortState(port, false);
+	}
+
+	return result;
+}
+
+// Buttons pressed by non-joystick source (e.g. keypad emulation), combined with physical devices on the same port
+void JoystickReporter::setVirtualButtons(uint8_t port, uint32_t buttons)
+{
+	if (port >= MAX_JOYSTICKS)
+		return;
+
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexPads);
+
+	JoystickPort& item = m_ports[port];
+	if (item.virtualButtons != buttons)
+	{
+		item.virtualButtons = buttons;
+		item.dirty = true;
+	}
+}
+
+// Muted port is reported to the core as released (input state is still tracked, see getInputState)
+void JoystickReporter::setMuted(uint8_t port, bool isMuted)
+{
+	if (port >= MAX_JOYSTICKS)
+		return;
+
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexPads);
+
+	JoystickPort& item = m_ports[port];
+	if (item.muted != isMuted)
+	{
+		item.muted = isMuted;
+		item.dirty = true;
+	}
+}
+
+// Buttons from <mask> are toggled with selected autofire rate while held
+void JoystickReporter::setAutofire(uint8_t port, uint32_t mask)
+{
+	if (port >= MAX_JOYSTICKS)
+		return;
+
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexPads);
+
+		m_ports[port].autofireMask = mask;
+		m_ports[port].dirty = true;
+	}
+
+	updateAutofireTimer();
+}
+
+void JoystickReporter::setAutofireRate(AutofireRateEnum rate)
+{
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexPads);
+
+		m_autofireRate = rate;
+	}
+
+	updateAutofireTimer();
+}
+
+AutofireRateEnum JoystickReporter::getAutofireRate()
+{
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexPads);
+
+	return m_autofireRate;
+}
+
+// Helper methods
+int JoystickReporter::findPad(const string& name)
+{
+	int result = -1;
+
+	for (int idx = 0; idx < MAX_INPUT_DEVICES; idx++)
+	{
+		if (m_pads[idx].active && m_pads[idx].name == name)
+		{
+			result = idx;
+			break;
+		}
+	}
+
+	return result;
+}
+
+// First port without any devices assigned (-1 if all ports are occupied)
+int JoystickReporter::findFreePort()
+{
+	bool occupied[MAX_JOYSTICKS] = { false };
+
+	for (auto& pad : m_pads)
+	{
+		if (pad.active)
+		{
+			occupied[pad.port] = true;
+		}
+	}
+
+	int result = -1;
+
+	for (int port = 0; port < MAX_JOYSTICKS; port++)
+	{
+		if (!occupied[port])
+		{
+			result = port;
+			break;
+		}
+	}
+
+	return result;
+}
+
+bool JoystickReporter::isPortDirty(uint8_t port)
+{
+	bool result = m_ports[port].dirty;
+
+	for (int idx = 0; !result && idx < MAX_INPUT_DEVICES; idx++)
+	{
+		result = m_pads[idx].active && m_pads[idx].dirty && m_pads[idx].port == port;
+	}
+
+	return result;
+}
+
+// Port state as combination of all devices assigned: buttons are OR-ed,
+// for each axis the most deflected value wins (so idle pad doesn't cancel active one)
+JoystickState JoystickReporter::getPortState(uint8_t port, bool applyAutofire)
+{
+	JoystickState result;
+
+	const JoystickPort& item = m_ports[port];
+	result.buttons = item.virtualButtons;
+
+	for (auto& pad : m_pads)
+	{
+		if (!pad.active || pad.port != port)
+			continue;
+
+		result.buttons |= pad.buttons | pad.hatButtons;
+
+		int8_t axes[JOYSTICK_MAX_AXES];
+		AnalogProcessor::process(pad.batch, pad.rawAxes, axes);
+
+		for (int i = 0; i < JOYSTICK_MAX_AXES; i++)
+		{
+			if (abs(axes[i]) > abs(result.axes[i]))
+			{
+				result.axes[i] = axes[i];
+			}
+		}
+	}
+
+	if (applyAutofire && !m_autofirePhase)
+	{
+		result.buttons &= ~item.autofireMask;
+	}
+
+	return result;
+}
+
+// Sends only parts of the port state that differ from previously sent. All ports are transferred
+// within single IO transaction (FPGA command lock taken once, commands are separated by IO strobe)
+// Returns false (nothing sent) if FPGA is busy with another transfer
+bool JoystickReporter::sendStates(const uint8_t* ports, unsigned count, const JoystickState* states)
+{
+	bool result = false;
+
+	FPGACommand* command = FPGADevice::instance().command;
+	if (command == nullptr || !command->startIO())
+		return result;
+
+	bool isFirst = true;
+
+	for (unsigned i = 0; i < count; i++)
+	{
+		uint8_t port = ports[i];
+		const JoystickState& state = states[port];
+		JoystickState& sent = m_ports[port].sent;
+
+		// Digital part (directions + buttons): 16-bit words, upper word only if any of upper buttons is (or was) pressed
+		if (!state.isButtonsEqual(sent))
+		{
+			uint16_t low = state.buttons;
+			uint16_t high = state.buttons >> 16;
+			uint8_t data[] = { (uint8_t)(low >> 8), (uint8_t)low, (uint8_t)(high >> 8), (uint8_t)high };
+			uint16_t length = (state.buttons | sent.buttons) >> 16 ? 4 : 2;
+
+			if (!isFirst)
+			{
+				command->nextIO();
+			}
+
+			command->sendCommand(getJoystickCommand(port), data, length);
+			isFirst = false;
+
+			sent.buttons = state.buttons;
+		}
+
+		// Analog part (primary stick only, as cores expect)
+		if (!state.isAxesEqual(sent))
+		{
+			uint8_t data[] = { port, (uint8_t)state.axes[0], (uint8_t)state.axes[1] };
+
+			if (!isFirst)
+			{
+				command->nextIO();
+			}
+
+			command->sendCommand(UIO_ASTICK, data, sizeof(data));
+			isFirst = false;
+
+			memcpy(sent.axes, state.axes, sizeof(sent.axes));
+		}
+	}
+
+	command->endIO();
+	result = true;
+
+	return result;
+}
+
+uint8_t JoystickReporter::getJoystickCommand(uint8_t port)
+{
+	uint8_t result = port < 2 ? UIO_JOYSTICK0 + port : UIO_JOYSTICK2 + port - 2;
+
+	return result;
+}
+
+uint32_t JoystickReporter::getAutofirePeriod(AutofireRateEnum rate)
+{
+	uint32_t result = 0;
+
+	switch (rate)
+	{
+		case AutofireRateEnum::Fast:
+			result = AUTOFIRE_PERIOD_FAST;
+			break;
+		case AutofireRateEnum::Medium:
+			result = AUTOFIRE_PERIOD_MEDIUM;
+			break;
+		case AutofireRateEnum::Slow:
+			result = AUTOFIRE_PERIOD_SLOW;
+			break;
+		default:
+			break;
+	}
+
+	return result;
+}
+
+// Timer runs only while autofire is enabled and assigned to at least one port
+// Must be called without m_mutexPads held (timer callback acquires it under timer service lock)
+void JoystickReporter::updateAutofireTimer()
+{
+	uint32_t period = 0;
+
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexPads);
+
+		bool hasAutofire = false;
+		for (int port = 0; port < MAX_JOYSTICKS; port++)
+		{
+			hasAutofire |= m_ports[port].autofireMask != 0;
+		}
+
+		period = hasAutofire ? getAutofirePeriod(m_autofireRate) : 0;
+
+		if (period == 0)
+		{
+			m_autofirePhase = true;
+		}
+	}
+
+	TimerService& timers = TimerService::instance();
+	if (period > 0)
+	{
+		timers.schedule(m_autofireTimer, period / 2, period / 2);
+	}
+	else
+	{
+		timers.cancel(m_autofireTimer);
+	}
+}
+
+// Called from timer service thread. Only flips the phase, transfer happens during next flush()
+void JoystickReporter::onAutofireTick()
+{
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexPads);
+
+	m_autofirePhase = !m_autofirePhase;
+
+	for (uint8_t port = 0; port < MAX_JOYSTICKS; port++)
+	{
+		JoystickPort& item = m_ports[port];
+		if (item.autofireMask != 0 && (getPortState(port, false).buttons & item.autofireMask))
+		{
+			item.dirty = true;
+		}
+	}
+}
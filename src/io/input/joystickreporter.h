@@ -0,0 +1,135 @@
+#ifndef IO_INPUT_JOYSTICKREPORTER_H_
+#define IO_INPUT_JOYSTICKREPORTER_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <linux/input.h>
+#include "../../common/consts.h"
+#include "../../common/messagetypes.h"
+#include "../../common/timer/timerwheel.h"
+#include "analogprocessor.h"
+#include "joystick.h"
+
+using namespace std;
+
+// Compact joystick state snapshot as it is sent to the core
+struct JoystickState
+{
+	static const uint8_t REPORTED_AXES = 2;		// Primary stick (X / Y) - the only axes sent to the core (UIO_ASTICK)
+
+	uint32_t buttons = 0;
+	int8_t axes[JOYSTICK_MAX_AXES] = { 0 };
+
+	bool isButtonsEqual(const JoystickState& that) const
+	{
+		return buttons == that.buttons;
+	}
+
+	// Other axes changes are not visible to the core, so they don't trigger a report
+	bool isAxesEqual(const JoystickState& that) const
+	{
+		return memcmp(axes, that.axes, REPORTED_AXES * sizeof(axes[0])) == 0;
+	}
+};
+typedef struct JoystickState JoystickState;
+
+// Joystick device assigned to the core port (several devices can share the same port)
+struct JoystickPad
+{
+	bool active = false;
+	string name;
+	uint8_t port = 0;
+
+	// EV_ABS code => axis slot mapping (copy from Joystick, so device instance is not accessed from poller thread)
+	int8_t axisSlots[ABS_CNT];
+	AxisCalibration calibrations[JOYSTICK_MAX_AXES];
+	AxisCalibrationBatch batch;
+
+	// Raw state accumulated from input events
+	int32_t rawAxes[JOYSTICK_MAX_AXES];
+	uint32_t buttons = 0;
+	uint32_t hatButtons = 0;
+	bool dirty = false;
+	uint64_t timestamp = 0;		// Kernel timestamp of the oldest change not reported yet (for latency tracing)
+};
+typedef struct JoystickPad JoystickPad;
+
+// Core port state aggregated from all devices assigned to it
+struct JoystickPort
+{
+	uint32_t virtualButtons = 0;	// Buttons from non-joystick sources (keypad emulation)
+	uint32_t autofireMask = 0;		// Buttons toggled by autofire timer while held
+	bool dirty = false;				// Port-level change (device removed, virtual buttons, autofire)
+	bool muted = false;				// Port state is consumed by other source (mouse emulation), core gets released port
+
+	// Last state successfully sent to the core
+	JoystickState sent;
+};
+typedef struct JoystickPort JoystickPort;
+
+// Accumulates joystick events (analog pads can produce thousands of axis events per second)
+// and reports resulting state to the core not more than once per frame and only if state changed.
+// All ports changed since the previous report are transferred within a single IO transaction
+class JoystickReporter
+{
+protected:
+	mutex m_mutexPads;
+	JoystickPad m_pads[MAX_INPUT_DEVICES];
+	JoystickPort m_ports[MAX_JOYSTICKS];
+
+	chrono::steady_clock::time_point m_lastReport;
+
+	// Autofire (shared phase for all ports, so shots are synchronized)
+	Timer m_autofireTimer;
+	AutofireRateEnum m_autofireRate = AutofireRateEnum::Off;
+	bool m_autofirePhase = true;		// false - autofire buttons are reported as released
+
+public:
+	// Singleton instance
+	static JoystickReporter& instance();
+	JoystickReporter(JoystickReporter&&) = delete;						// Disable move constructor (C++11 feature)
+	JoystickReporter(const JoystickReporter& that) = delete; 			// Disable copy constructor (C++11 feature)
+	JoystickReporter& operator =(JoystickReporter const&) = delete;		// Disable assignment operator (C++11 feature)
+	virtual ~JoystickReporter() {};
+
+public:
+	int addJoystick(Joystick* joystick, int port = -1);
+	void removeJoystick(const string& name);
+	bool setPort(const string& name, uint8_t port);
+	void setAxisCalibration(const string& name, uint8_t slot, const AxisCalibration& calibration);
+	void reset();
+
+	bool update(const MInputMessage& message);
+	void flush();
+
+	JoystickState getState(uint8_t port);
+	JoystickState getInputState(uint8_t port);
+	void setVirtualButtons(uint8_t port, uint32_t buttons);
+	void setMuted(uint8_t port, bool isMuted);
+
+	void setAutofire(uint8_t port, uint32_t mask);
+	void setAutofireRate(AutofireRateEnum rate);
+	AutofireRateEnum getAutofireRate();
+
+// Helper methods
+protected:
+	int findPad(const string& name);
+	int findFreePort();
+	bool isPortDirty(uint8_t port);
+	JoystickState getPortState(uint8_t port, bool applyAutofire);
+	bool sendStates(const uint8_t* ports, unsigned count, const JoystickState* states);
+
+	static uint8_t getJoystickCommand(uint8_t port);
+	static uint32_t getAutofirePeriod(AutofireRateEnum rate);
+
+	void updateAutofireTimer();
+	void onAutofireTick();
+
+private:
+	JoystickReporter();	// Disable explicit object creation (only singleton instance allowed)
+};
+
+#endif /* IO_INPUT_JOYSTICKREPORTER_H_ */
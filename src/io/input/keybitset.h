@@ -0,0 +1,84 @@
+#ifndef IO_INPUT_KEYBITSET_H_
+#define IO_INPUT_KEYBITSET_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <linux/input.h>
+
+using namespace std;
+
+#define KEYBITSET_BITS_PER_WORD 32
+#define KEYBITSET_WORDS ((KEY_CNT + KEYBITSET_BITS_PER_WORD - 1) / KEYBITSET_BITS_PER_WORD)
+
+// Fixed-size bitset covering all key codes [0..KEY_MAX]. Stored as 32-bit words (native for ARM Cortex-A9)
+// All operations are O(1) (or O(KEYBITSET_WORDS) for whole-set operations) and allocation-free
+struct KeyBitset
+{
+	uint32_t words[KEYBITSET_WORDS];
+
+	KeyBitset() { clear(); };
+
+	inline void clear()
+	{
+		memset(words, 0, sizeof(words));
+	}
+
+	inline void set(uint16_t key, bool state)
+	{
+		if (key > KEY_MAX)
+			return;
+
+		uint32_t mask = getMask(key);
+		uint32_t& word = words[getWord(key)];
+		word = state ? word | mask : word & ~mask;
+	}
+
+	inline bool test(uint16_t key) const
+	{
+		bool result = false;
+
+		if (key <= KEY_MAX)
+		{
+			result = (words[getWord(key)] & getMask(key)) != 0;
+		}
+
+		return result;
+	}
+
+	inline bool isEmpty() const
+	{
+		uint32_t result = 0;
+
+		for (unsigned i = 0; i < KEYBITSET_WORDS; i++)
+			result |= words[i];
+
+		return result == 0;
+	}
+
+	// Keys that are set in <current> but not in <previous> (0 -> 1 transitions)
+	static inline void getPressed(const KeyBitset& current, const KeyBitset& previous, KeyBitset& out)
+	{
+		for (unsigned i = 0; i < KEYBITSET_WORDS; i++)
+			out.words[i] = (current.words[i] ^ previous.words[i]) & current.words[i];
+	}
+
+	// Keys that are set in <previous> but not in <current> (1 -> 0 transitions)
+	static inline void getReleased(const KeyBitset& current, const KeyBitset& previous, KeyBitset& out)
+	{
+		for (unsigned i = 0; i < KEYBITSET_WORDS; i++)
+			out.words[i] = (current.words[i] ^ previous.words[i]) & previous.words[i];
+	}
+
+	static inline unsigned getWord(uint16_t key)
+	{
+		return key / KEYBITSET_BITS_PER_WORD;
+	}
+
+	static inline uint32_t getMask(uint16_t key)
+	{
+		return 1u << (key % KEYBITSET_BITS_PER_WORD);
+	}
+};
+typedef struct KeyBitset KeyBitset;
+
+#endif /* IO_INPUT_KEYBITSET_H_ */
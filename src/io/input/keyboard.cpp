@@ -11,7 +11,6 @@
 #include "../../3rdparty/tinyformat/tinyformat.h"
 #include "../../common/consts.h"
 #include "../../common/exception/misterexception.h"
-#include "../../common/helpers/collectionhelper.h"
 
 Keyboard::Keyboard(const string& name, const string& path) : BaseInputDevice(name, path)
 {
@@ -26,6 +25,7 @@ void Keyboard::reset()
 {
 	// Reset all internal buffers and states
 	m_keysState.clear();
+	m_prevKeysState.clear();
 	memset(bit_key, 0, sizeof(bit_key));
 }
 
@@ -127,47 +127,88 @@ void Keyboard::makeLEDEvent(struct input_event* event, uint16_t ledMask, bool on
 
 void Keyboard::setKeyState(uint16_t key, bool state)
 {
-	if (key_exists(m_keysState, key))
-	{
-		m_keysState[key] = state;
-	}
-	else
-	{
-		m_keysState.insert( {key, state} );
-	}
+	m_keysState.set(key, state);
 }
 
 bool Keyboard::getKeyState(uint16_t key)
+{
+	bool result = m_keysState.test(key);
+
+	return result;
+}
+
+void Keyboard::setPrevKeyState(uint16_t key, bool state)
+{
+	m_prevKeysState.set(key, state);
+}
+
+bool Keyboard::getPrevKeyState(uint16_t key)
+{
+	bool result = m_prevKeysState.test(key);
+
+	return result;
+}
+
+// Remember current state as previous. Should be called once all events from a message are processed
+void Keyboard::commitKeyState()
+{
+	m_prevKeysState = m_keysState;
+}
+
+bool Keyboard::isKeyPressedEdge(uint16_t key)
 {
 	bool result = false;
 
-	if (key_exists(m_keysState, key))
+	if (key <= KEY_MAX)
 	{
-		result = m_keysState[key];
+		unsigned word = KeyBitset::getWord(key);
+		result = (m_keysState.words[word] & ~m_prevKeysState.words[word] & KeyBitset::getMask(key)) != 0;
 	}
 
 	return result;
 }
 
-void Keyboard::setPrevKeyState(uint16_t key, bool state)
+bool Keyboard::isKeyReleasedEdge(uint16_t key)
 {
-	if (key_exists(m_prevKeysState, key))
-	{
-		m_prevKeysState[key] = state;
-	}
-	else
+	bool result = false;
+
+	if (key <= KEY_MAX)
 	{
-		m_prevKeysState.insert( {key, state} );
+		unsigned word = KeyBitset::getWord(key);
+		result = (~m_keysState.words[word] & m_prevKeysState.words[word] & KeyBitset::getMask(key)) != 0;
 	}
+
+	return result;
 }
 
-bool Keyboard::getPrevKeyState(uint16_t key)
+void Keyboard::getPressedKeys(KeyBitset& out)
 {
-	bool result = false;
+	KeyBitset::getPressed(m_keysState, m_prevKeysState, out);
+}
+
+void Keyboard::getReleasedKeys(KeyBitset& out)
+{
+	KeyBitset::getReleased(m_keysState, m_prevKeysState, out);
+}
 
-	if (key_exists(m_prevKeysState, key))
+char Keyboard::getKeyChar(uint16_t key)
+{
+	// Key codes KEY_1 (2) .. KEY_M (50), follow physical US keyboard rows
+	static const char symbols[] =
+		"1234567890-=\0\0"		// KEY_1 .. KEY_TAB
+		"qwertyuiop[]\0\0"		// KEY_Q .. KEY_LEFTCTRL
+		"asdfghjkl;'`\0\\"	// KEY_A .. KEY_BACKSLASH
+		"zxcvbnm";				// KEY_Z .. KEY_M
+
+	char result = '\0';
+
+	if (key >= KEY_1 && key <= KEY_M)
+	{
+		result = symbols[key - KEY_1];
+	}
+	else if (key == KEY_SPACE)
 	{
-		result = m_prevKeysState[key];
+		result = ' ';
 	}
 
 	return result;
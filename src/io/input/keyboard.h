@@ -2,15 +2,13 @@
 #define IO_INPUT_KEYBOARD_H_
 
 #include <stdint.h>
-#include <map>
 #include <string>
 #include "../../common/consts.h"
 #include "baseinputdevice.h"
+#include "keybitset.h"
 
 using namespace std;
 
-typedef map<uint16_t, bool> KeyStateMap;
-
 class Keyboard : public BaseInputDevice
 {
 	friend class InputManager;
@@ -20,8 +18,9 @@ protected:
 	unsigned long bit_led[BITFIELD_LONGS_PER_ARRAY(LED_MAX)];
 	uint16_t supportedLEDBits = 0x0000;
 
-	KeyStateMap m_keysState;
-	KeyStateMap m_prevKeysState;
+	// Key states as received from events (current) and as they were at the moment of last commitKeyState() call
+	KeyBitset m_keysState;
+	KeyBitset m_prevKeysState;
 
 public:
 	Keyboard(const string& name, const string& path);
@@ -45,6 +44,19 @@ public:
 	bool getKeyState(uint16_t key);
 	void setPrevKeyState(uint16_t key, bool state);
 	bool getPrevKeyState(uint16_t key);
+	void commitKeyState();
+
+	const KeyBitset& getKeysState() const { return m_keysState; };
+	const KeyBitset& getPrevKeysState() const { return m_prevKeysState; };
+
+	// Edge detection (relative to the last committed state)
+	bool isKeyPressedEdge(uint16_t key);
+	bool isKeyReleasedEdge(uint16_t key);
+	void getPressedKeys(KeyBitset& out);
+	void getReleasedKeys(KeyBitset& out);
+
+	// Printable symbol for letter / digit / space keys (lowercase, no layout support). '\0' for other keys
+	static char getKeyChar(uint16_t key);
 
 	// Debug methods
 	string dumpKeyBits();
@@ -0,0 +1,124 @@
+#include "keychord.h"
+
+#include "../../common/logger/logger.h"
+
+KeyChord::KeyChord(uint16_t trigger)
+{
+	m_trigger = trigger;
+}
+
+KeyChord::KeyChord(const initializer_list<uint16_t>& anyOf, uint16_t trigger)
+{
+	m_trigger = trigger;
+	requireAny(anyOf);
+}
+
+KeyChord& KeyChord::require(uint16_t key)
+{
+	addTerm(key, 0);
+
+	return *this;
+}
+
+KeyChord& KeyChord::requireAny(const initializer_list<uint16_t>& keys)
+{
+	if (m_groupCount >= 31)
+	{
+		LOGWARN("%s: too many key groups in a chord", __PRETTY_FUNCTION__);
+		return *this;
+	}
+
+	uint8_t group = ++m_groupCount;
+	m_groupsRequired |= 1u << group;
+
+	for (uint16_t key : keys)
+	{
+		addTerm(key, group);
+	}
+
+	return *this;
+}
+
+// True if all modifiers are held (trigger key state is not checked)
+bool KeyChord::isHeld(const KeyBitset& state) const
+{
+	uint32_t groupsMatched = 0;
+	bool requiredMatched = true;
+
+	for (unsigned i = 0; i < m_termCount; i++)
+	{
+		const KeyChordTerm& term = m_terms[i];
+		uint32_t bits = state.words[term.word] & term.mask;
+
+		if (term.group == 0)
+		{
+			requiredMatched &= bits == term.mask;
+		}
+		else if (bits != 0)
+		{
+			groupsMatched |= 1u << term.group;
+		}
+	}
+
+	bool result = requiredMatched && (groupsMatched & m_groupsRequired) == m_groupsRequired;
+
+	return result;
+}
+
+// True if trigger key was just pressed while all modifiers are held
+bool KeyChord::match(const KeyBitset& state, const KeyBitset& prevState) const
+{
+	unsigned word = KeyBitset::getWord(m_trigger);
+	uint32_t mask = KeyBitset::getMask(m_trigger);
+
+	// Positive edge for trigger key
+	if ((state.words[word] & ~prevState.words[word] & mask) == 0)
+		return false;
+
+	bool result = isHeld(state);
+
+	return result;
+}
+
+// Adds all keys participating in the chord (modifiers and trigger) to <keys>
+void KeyChord::getKeys(KeyBitset& keys) const
+{
+	for (unsigned i = 0; i < m_termCount; i++)
+	{
+		const KeyChordTerm& term = m_terms[i];
+		keys.words[term.word] |= term.mask;
+	}
+
+	keys.set(m_trigger, true);
+}
+
+// Helper methods
+
+// Keys with the same word and group are merged into a single term
+void KeyChord::addTerm(uint16_t key, uint8_t group)
+{
+	if (key > KEY_MAX)
+		return;
+
+	uint8_t word = KeyBitset::getWord(key);
+	uint32_t mask = KeyBitset::getMask(key);
+
+	for (unsigned i = 0; i < m_termCount; i++)
+	{
+		KeyChordTerm& term = m_terms[i];
+		if (term.word == word && term.group == group)
+		{
+			term.mask |= mask;
+			return;
+		}
+	}
+
+	if (m_termCount < KEYCHORD_MAX_TERMS)
+	{
+		m_terms[m_termCount++] = { word, group, mask };
+	}
+	else
+	{
+		LOGWARN("%s: chord is too complex, key 0x%x ignored", __PRETTY_FUNCTION__, key);
+	}
+}
@@ -0,0 +1,56 @@
+#ifndef IO_INPUT_KEYCHORD_H_
+#define IO_INPUT_KEYCHORD_H_
+
+#include <stdint.h>
+#include <initializer_list>
+#include "keybitset.h"
+
+using namespace std;
+
+#define KEYCHORD_MAX_TERMS 8
+
+// Single word-level condition of a chord
+struct KeyChordTerm
+{
+	uint8_t word;		// Index of the word in KeyBitset
+	uint8_t group;		// 0 - all keys from mask are required; 1..31 - at least one key from the group is required
+	uint32_t mask;
+};
+typedef struct KeyChordTerm KeyChordTerm;
+
+// Multi-key hotkey (like Alt+F12) compiled into a few (word, mask) terms
+// Chord matches when:
+//	- trigger key was pressed during current frame (0 -> 1 transition)
+//	- all required keys are held
+//	- at least one key from each any-of group is held (i.e. Left or Right Alt)
+// Chords are expected to be built once (i.e. as class members), matching is allocation-free
+class KeyChord
+{
+protected:
+	uint16_t m_trigger = KEY_RESERVED;
+
+	KeyChordTerm m_terms[KEYCHORD_MAX_TERMS];
+	uint8_t m_termCount = 0;
+	uint8_t m_groupCount = 0;
+	uint32_t m_groupsRequired = 0;
+
+public:
+	KeyChord() {};
+	KeyChord(uint16_t trigger);
+	KeyChord(const initializer_list<uint16_t>& anyOf, uint16_t trigger);
+
+	KeyChord& require(uint16_t key);
+	KeyChord& requireAny(const initializer_list<uint16_t>& keys);
+
+	uint16_t getTrigger() const { return m_trigger; };
+	void getKeys(KeyBitset& keys) const;
+
+	bool isHeld(const KeyBitset& state) const;
+	bool match(const KeyBitset& state, const KeyBitset& prevState) const;
+
+// Helper methods
+protected:
+	void addTerm(uint16_t key, uint8_t group);
+};
+
+#endif /* IO_INPUT_KEYCHORD_H_ */
@@ -0,0 +1,384 @@
+#include "inputloadgenerator.h"
+
+#include "../../../common/logger/logger.h"
+
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <linux/input.h>
+#include "../../../3rdparty/tinyformat/tinyformat.h"
+#include "../../../common/diagnostics/latencytracer.h"
+#include "../../../common/thread/threadpolicy.h"
+#include "../inputmanager.h"
+#include "../inputpoll/inputpoller.h"
+
+InputLoadGenerator::~InputLoadGenerator()
+{
+	destroyDevices();
+}
+
+// Runs the test synchronously (blocks for profile duration + device registration time)
+bool InputLoadGenerator::run(InputLoadResult& result)
+{
+	m_stop = false;
+	result = InputLoadResult();
+
+	if (!createDevices())
+	{
+		destroyDevices();
+		return false;
+	}
+
+	// Devices are picked up asynchronously by DeviceDetector (inotify on /dev/input)
+	if (!waitForRegistration(3000))
+	{
+		LOGERROR("%s: virtual devices were not registered by InputManager. Is DeviceDetector running?", __PRETTY_FUNCTION__);
+
+		destroyDevices();
+		return false;
+	}
+
+	// Tracing is enabled for the test duration only (unless it was enabled already)
+	LatencyTracer& tracer = LatencyTracer::instance();
+	bool isTracerEnabled = tracer.isEnabled();
+	tracer.setEnabled(true);
+	tracer.reset();
+
+	InputPoller& poller = InputPoller::instance();
+	InputPollerStatistics before = poller.getStatistics();
+
+	auto started = chrono::steady_clock::now();
+
+	// Each device is driven by own thread, so patterns with different rates don't affect each other
+	vector<thread> workers;
+	unsigned seed = 1;
+	for (auto& device : m_devices)
+	{
+		UInputDevice* uinputDevice = device.get();
+		unsigned deviceSeed = seed++;
+
+		workers.emplace_back([this, uinputDevice, deviceSeed]()
+		{
+			const string threadName("input_load");
+			ThreadPolicy::getDefault(threadName).apply(threadName);
+
+			switch (uinputDevice->getType())
+			{
+				case InputDeviceTypeEnum::Keyboard:
+					driveKeyboard(*uinputDevice);
+					break;
+				case InputDeviceTypeEnum::Mouse:
+					driveMouse(*uinputDevice);
+					break;
+				case InputDeviceTypeEnum::Joystick:
+					driveJoystick(*uinputDevice, deviceSeed);
+					break;
+				default:
+					break;
+			}
+		});
+	}
+
+	// Wait for test completion (can be interrupted by stop())
+	auto deadline = started + chrono::milliseconds(m_profile.duration);
+	while (!m_stop && chrono::steady_clock::now() < deadline)
+	{
+		usleep(10 * 1000);
+	}
+
+	m_stop = true;
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+
+	result.duration = (unsigned)chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - started).count();
+
+	// Let the pipeline drain queued events
+	usleep(200 * 1000);
+
+	InputPollerStatistics after = poller.getStatistics();
+	result.eventsRead = after.eventsRead - before.eventsRead;
+	result.packetsPosted = after.packetsPosted - before.packetsPosted;
+	result.overflows = after.overflows - before.overflows;
+	result.eventsDropped = after.eventsDropped - before.eventsDropped;
+
+	for (auto& device : m_devices)
+	{
+		InputLoadDeviceResult deviceResult;
+		deviceResult.model = device->getModel();
+		deviceResult.eventName = device->getEventName();
+		deviceResult.eventsSent = device->getEventsSent();
+		deviceResult.packetsSent = device->getPacketsSent();
+
+		// End-to-end latency: kernel timestamp -> dispatched to CommandCenter
+		LatencyHistogram histogram = tracer.getHistogram(deviceResult.eventName, LatencyStageEnum::Dispatch);
+		deviceResult.samples = histogram.getCount();
+		deviceResult.p50 = histogram.getPercentile(50);
+		deviceResult.p95 = histogram.getPercentile(95);
+		deviceResult.p99 = histogram.getPercentile(99);
+		deviceResult.max = histogram.getMax();
+
+		result.eventsSent += deviceResult.eventsSent;
+		result.packetsSent += deviceResult.packetsSent;
+		result.devices.push_back(deviceResult);
+	}
+
+	tracer.setEnabled(isTracerEnabled);
+
+	destroyDevices();
+
+	return true;
+}
+
+void InputLoadGenerator::stop()
+{
+	m_stop = true;
+}
+
+// Debug methods
+
+string InputLoadGenerator::dump(const InputLoadResult& result)
+{
+	stringstream ss;
+
+	double seconds = result.duration > 0 ? result.duration / 1000.0 : 1.0;
+
+	ss << tfm::format("Input load test: %u ms", result.duration) << endl;
+	ss << tfm::format("  sent:     %llu events, %llu packets (%.0f packets/s)",
+		result.eventsSent, result.packetsSent, result.packetsSent / seconds) << endl;
+	ss << tfm::format("  received: %llu events, %llu messages posted (%.0f messages/s)",
+		result.eventsRead, result.packetsPosted, result.packetsPosted / seconds) << endl;
+	ss << tfm::format("  dropped:  %llu events (%llu SYN_DROPPED)", result.eventsDropped, result.overflows) << endl;
+
+	for (const InputLoadDeviceResult& device : result.devices)
+	{
+		ss << tfm::format("  %-10s %-24s packets: %-8llu latency (us) samples: %-8u p50: %-6u p95: %-6u p99: %-6u max: %u",
+			device.eventName.c_str(), device.model.c_str(), device.packetsSent,
+			device.samples, device.p50, device.p95, device.p99, device.max) << endl;
+	}
+
+	return ss.str();
+}
+
+// Helper methods
+
+bool InputLoadGenerator::createDevices()
+{
+	bool result = true;
+
+	destroyDevices();
+
+	auto add = [&](InputDeviceTypeEnum type, unsigned count, const char* name)
+	{
+		for (unsigned i = 0; result && i < count; i++)
+		{
+			unique_ptr<UInputDevice> device(new UInputDevice());
+			result = device->create(type, tfm::format("MiSTer load %s %u", name, i));
+
+			if (result)
+			{
+				m_devices.push_back(move(device));
+			}
+		}
+	};
+
+	add(InputDeviceTypeEnum::Keyboard, m_profile.keyboards, "keyboard");
+	add(InputDeviceTypeEnum::Mouse, m_profile.mice, "mouse");
+	add(InputDeviceTypeEnum::Joystick, m_profile.joysticks, "joystick");
+
+	return result;
+}
+
+void InputLoadGenerator::destroyDevices()
+{
+	m_devices.clear();
+}
+
+bool InputLoadGenerator::waitForRegistration(unsigned timeout)
+{
+	bool result = false;
+
+	InputManager& inputmgr = InputManager::instance();
+	auto deadline = chrono::steady_clock::now() + chrono::milliseconds(timeout);
+
+	while (!result && chrono::steady_clock::now() < deadline)
+	{
+		result = true;
+
+		{
+			// Lock parallel threads to access (active till the end of the block)
+			lock_guard<mutex> lock(inputmgr.m_mutexDevices);
+
+			for (auto& device : m_devices)
+			{
+				if (inputmgr.findInputDeviceByName(device->getEventName()) == nullptr)
+				{
+					result = false;
+					break;
+				}
+			}
+		}
+
+		if (!result)
+		{
+			usleep(50 * 1000);
+		}
+	}
+
+	return result;
+}
+
+// Bursts of key presses / releases (letters only, so no menu / emulation hotkeys are triggered)
+void InputLoadGenerator::driveKeyboard(UInputDevice& device)
+{
+	static const uint16_t keys[] =
+	{
+		KEY_Q, KEY_W, KEY_E, KEY_R, KEY_T, KEY_Y, KEY_U, KEY_I, KEY_O, KEY_P,
+		KEY_A, KEY_S, KEY_D, KEY_F, KEY_G, KEY_H, KEY_J, KEY_K, KEY_L,
+		KEY_Z, KEY_X, KEY_C, KEY_V, KEY_B, KEY_N, KEY_M
+	};
+	const unsigned keysCount = sizeof(keys) / sizeof(keys[0]);
+
+	struct timespec deadline;
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+	unsigned position = 0;
+	while (!m_stop)
+	{
+		unsigned burstStart = position;
+
+		for (unsigned i = 0; i < m_profile.keyBurstSize; i++)
+		{
+			device.emit(EV_KEY, keys[(burstStart + i) % keysCount], 1);
+			device.sync();
+		}
+
+		for (unsigned i = 0; i < m_profile.keyBurstSize; i++)
+		{
+			device.emit(EV_KEY, keys[(burstStart + i) % keysCount], 0);
+			device.sync();
+		}
+
+		position = (burstStart + m_profile.keyBurstSize) % keysCount;
+
+		sleepUntil(deadline, m_profile.keyBurstInterval * 1000);
+	}
+}
+
+// Circular motion with left button clicks
+void InputLoadGenerator::driveMouse(UInputDevice& device)
+{
+	static const int8_t directions[][2] = { { 2, 0 }, { 1, 1 }, { 0, 2 }, { -1, 1 }, { -2, 0 }, { -1, -1 }, { 0, -2 }, { 1, -1 } };
+
+	unsigned interval = m_profile.mouseRate > 0 ? 1000000 / m_profile.mouseRate : 1000;
+
+	struct timespec deadline;
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+	unsigned packet = 0;
+	bool pressed = false;
+	while (!m_stop)
+	{
+		const int8_t* direction = directions[(packet / 64) % 8];
+
+		device.emit(EV_REL, REL_X, direction[0]);
+		device.emit(EV_REL, REL_Y, direction[1]);
+
+		if (packet % 100 == 0)
+		{
+			pressed = !pressed;
+			device.emit(EV_KEY, BTN_LEFT, pressed ? 1 : 0);
+		}
+
+		device.sync();
+		packet++;
+
+		sleepUntil(deadline, interval);
+	}
+
+	if (pressed)
+	{
+		device.emit(EV_KEY, BTN_LEFT, 0);
+		device.sync();
+	}
+}
+
+// Sticks slowly rotating with random noise on top (worst case for analog processing - every axis changes each packet)
+void InputLoadGenerator::driveJoystick(UInputDevice& device, unsigned seed)
+{
+	static const int32_t circle[][2] =
+	{
+		{ 24000, 0 }, { 16970, 16970 }, { 0, 24000 }, { -16970, 16970 },
+		{ -24000, 0 }, { -16970, -16970 }, { 0, -24000 }, { 16970, -16970 }
+	};
+
+	unsigned interval = m_profile.joystickRate > 0 ? 1000000 / m_profile.joystickRate : 4000;
+	uint32_t random = seed * 2654435761u;
+
+	auto noise = [&]() -> int32_t
+	{
+		// Simple LCG is enough here (and deterministic across runs)
+		random = random * 1664525u + 1013904223u;
+		int32_t amplitude = m_profile.axisNoise;
+
+		return amplitude > 0 ? (int32_t)((random >> 8) % (2 * amplitude + 1)) - amplitude : 0;
+	};
+
+	auto clamp = [](int32_t value) -> int32_t
+	{
+		return value > 32767 ? 32767 : value < -32768 ? -32768 : value;
+	};
+
+	struct timespec deadline;
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+	unsigned packet = 0;
+	unsigned buttons = 0;
+	while (!m_stop)
+	{
+		const int32_t* position = circle[(packet / 32) % 8];
+
+		device.emit(EV_ABS, ABS_X, clamp(position[0] + noise()));
+		device.emit(EV_ABS, ABS_Y, clamp(position[1] + noise()));
+		device.emit(EV_ABS, ABS_RX, clamp(-position[0] + noise()));
+		device.emit(EV_ABS, ABS_RY, clamp(-position[1] + noise()));
+
+		if (m_profile.buttonInterval > 0 && packet % m_profile.buttonInterval == 0)
+		{
+			// Walk through buttons pressing one at a time
+			unsigned button = (packet / m_profile.buttonInterval) % (BTN_THUMBR - BTN_SOUTH + 1);
+			device.emit(EV_KEY, BTN_SOUTH + buttons, 0);
+			device.emit(EV_KEY, BTN_SOUTH + button, 1);
+			device.emit(EV_ABS, ABS_HAT0X, (int32_t)(button % 3) - 1);
+			buttons = button;
+		}
+
+		device.sync();
+		packet++;
+
+		sleepUntil(deadline, interval);
+	}
+
+	device.emit(EV_KEY, BTN_SOUTH + buttons, 0);
+	device.emit(EV_ABS, ABS_HAT0X, 0);
+	device.sync();
+}
+
+// Absolute deadlines keep configured rate stable regardless of time spent on writes
+void InputLoadGenerator::sleepUntil(struct timespec& deadline, unsigned intervalUs)
+{
+	deadline.tv_nsec += (long)intervalUs * 1000;
+	while (deadline.tv_nsec >= 1000000000L)
+	{
+		deadline.tv_nsec -= 1000000000L;
+		deadline.tv_sec++;
+	}
+
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR)
+	{
+	}
+}
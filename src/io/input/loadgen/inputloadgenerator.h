@@ -0,0 +1,95 @@
+#ifndef IO_INPUT_LOADGEN_INPUTLOADGENERATOR_H_
+#define IO_INPUT_LOADGEN_INPUTLOADGENERATOR_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include "uinputdevice.h"
+
+using namespace std;
+
+// Load pattern parameters (rates are in packets per second, i.e. events delimited by SYN_REPORT)
+struct InputLoadProfile
+{
+	unsigned keyboards = 1;
+	unsigned mice = 1;
+	unsigned joysticks = 1;
+
+	unsigned duration = 10000;			// Test duration (ms)
+
+	unsigned keyBurstSize = 16;			// Keys pressed and released back-to-back within single burst
+	unsigned keyBurstInterval = 100;		// Pause between bursts (ms)
+
+	unsigned mouseRate = 1000;			// 1000Hz gaming mouse
+
+	unsigned joystickRate = 250;
+	int32_t axisNoise = 2048;			// Random noise amplitude added to each analog axis (raw units)
+	unsigned buttonInterval = 50;		// Button state toggled each N packets
+};
+typedef struct InputLoadProfile InputLoadProfile;
+
+// Per virtual device results
+struct InputLoadDeviceResult
+{
+	string model;
+	string eventName;
+	uint64_t eventsSent = 0;
+	uint64_t packetsSent = 0;
+	uint32_t samples = 0;				// Latency samples collected by the input stack for this device
+	uint32_t p50 = 0;
+	uint32_t p95 = 0;
+	uint32_t p99 = 0;
+	uint32_t max = 0;
+};
+typedef struct InputLoadDeviceResult InputLoadDeviceResult;
+
+struct InputLoadResult
+{
+	unsigned duration = 0;				// Real test duration (ms)
+	uint64_t eventsSent = 0;
+	uint64_t packetsSent = 0;
+	uint64_t eventsRead = 0;			// Raw events read by InputPoller during the test
+	uint64_t packetsPosted = 0;		// Messages posted by InputPoller during the test
+	uint64_t overflows = 0;			// SYN_DROPPED occurrences
+	uint64_t eventsDropped = 0;
+	vector<InputLoadDeviceResult> devices;
+};
+typedef struct InputLoadResult InputLoadResult;
+
+// Synthetic input load generator.
+// Creates virtual keyboards / mice / joysticks via uinput and drives them with configured patterns.
+// Devices go through the real pipeline (DeviceDetector -> InputManager -> InputPoller -> MessageCenter -> CommandCenter),
+// so results reflect throughput and latency of the whole input stack
+class InputLoadGenerator
+{
+protected:
+	InputLoadProfile m_profile;
+	vector<unique_ptr<UInputDevice>> m_devices;
+	atomic<bool> m_stop;
+
+public:
+	InputLoadGenerator(const InputLoadProfile& profile) : m_profile(profile), m_stop(false) {};
+	virtual ~InputLoadGenerator();
+
+	bool run(InputLoadResult& result);
+	void stop();
+
+	// Debug methods
+	static string dump(const InputLoadResult& result);
+
+// Helper methods
+protected:
+	bool createDevices();
+	void destroyDevices();
+	bool waitForRegistration(unsigned timeout);
+
+	void driveKeyboard(UInputDevice& device);
+	void driveMouse(UInputDevice& device);
+	void driveJoystick(UInputDevice& device, unsigned seed);
+
+	static void sleepUntil(struct timespec& deadline, unsigned intervalUs);
+};
+
+#endif /* IO_INPUT_LOADGEN_INPUTLOADGENERATOR_H_ */
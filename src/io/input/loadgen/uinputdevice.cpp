@@ -0,0 +1,249 @@
+#include "uinputdevice.h"
+
+#include "../../../common/logger/logger.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/input.h>
+#include <linux/uinput.h>
+#include "../../../common/file/path/path.h"
+#include "../../../common/file/scandir/scandir.h"
+
+UInputDevice::~UInputDevice()
+{
+	destroy();
+}
+
+bool UInputDevice::create(InputDeviceTypeEnum type, const string& model)
+{
+	bool result = false;
+
+	destroy();
+
+	m_fd = open(LINUX_UINPUT_DEVICE, O_WRONLY | O_NONBLOCK);
+	if (m_fd == INVALID_FILE_DESCRIPTOR)
+	{
+		LOGERROR("%s: unable to open '%s': %s", __PRETTY_FUNCTION__, LINUX_UINPUT_DEVICE, logger::geterror());
+		return result;
+	}
+
+	m_type = type;
+	m_model = model;
+
+	// Legacy setup structure is used (instead of UI_DEV_SETUP / UI_ABS_SETUP) to support older kernels
+	struct uinput_user_dev setup;
+	memset(&setup, 0, sizeof(setup));
+	strncpy(setup.name, model.c_str(), UINPUT_MAX_NAME_SIZE - 1);
+	setup.id.bustype = BUS_VIRTUAL;
+	setup.id.vendor = 0x1209;	// pid.codes test VID
+	setup.id.product = 0x0001 + type._to_integral();
+	setup.id.version = 1;
+
+	bool isConfigured = false;
+	switch (type)
+	{
+		case InputDeviceTypeEnum::Keyboard:
+			isConfigured = setupKeyboard();
+			break;
+		case InputDeviceTypeEnum::Mouse:
+			isConfigured = setupMouse();
+			break;
+		case InputDeviceTypeEnum::Joystick:
+			isConfigured = setupJoystick();
+
+			// Full 16-bit range for analog sticks, hats are -1..1
+			for (int axis : { ABS_X, ABS_Y, ABS_RX, ABS_RY })
+			{
+				setup.absmin[axis] = -32768;
+				setup.absmax[axis] = 32767;
+				setup.absflat[axis] = 128;
+			}
+			for (int axis : { ABS_HAT0X, ABS_HAT0Y })
+			{
+				setup.absmin[axis] = -1;
+				setup.absmax[axis] = 1;
+			}
+			break;
+		default:
+			LOGERROR("%s: unsupported device type '%s'", __PRETTY_FUNCTION__, type._to_string());
+			break;
+	}
+
+	if (isConfigured &&
+		write(m_fd, &setup, sizeof(setup)) == sizeof(setup) &&
+		ioctl(m_fd, UI_DEV_CREATE) >= 0)
+	{
+		m_eventName = queryEventName();
+		result = true;
+
+		LOGINFO("Virtual %s '%s' created as '%s'", type._to_string(), model.c_str(), m_eventName.c_str());
+	}
+	else
+	{
+		LOGERROR("%s: unable to create virtual device '%s': %s", __PRETTY_FUNCTION__, model.c_str(), logger::geterror());
+
+		close(m_fd);
+		m_fd = INVALID_FILE_DESCRIPTOR;
+	}
+
+	return result;
+}
+
+void UInputDevice::destroy()
+{
+	if (m_fd != INVALID_FILE_DESCRIPTOR)
+	{
+		ioctl(m_fd, UI_DEV_DESTROY);
+		close(m_fd);
+
+		m_fd = INVALID_FILE_DESCRIPTOR;
+		m_eventName.clear();
+	}
+}
+
+bool UInputDevice::emit(uint16_t type, uint16_t code, int32_t value)
+{
+	bool result = false;
+
+	struct input_event event;
+	memset(&event, 0, sizeof(event));
+	event.type = type;
+	event.code = code;
+	event.value = value;
+
+	// Kernel sets event timestamp by itself, so latency is measured from the moment of write
+	if (write(m_fd, &event, sizeof(event)) == sizeof(event))
+	{
+		m_eventsSent++;
+		result = true;
+	}
+
+	return result;
+}
+
+bool UInputDevice::sync()
+{
+	bool result = emit(EV_SYN, SYN_REPORT, 0);
+
+	if (result)
+	{
+		m_packetsSent++;
+	}
+
+	return result;
+}
+
+InputDeviceTypeEnum UInputDevice::getType()
+{
+	return m_type;
+}
+
+const string& UInputDevice::getModel()
+{
+	return m_model;
+}
+
+// Name of evdev node (event<N>) the device is registered with in /dev/input
+const string& UInputDevice::getEventName()
+{
+	return m_eventName;
+}
+
+uint64_t UInputDevice::getEventsSent()
+{
+	return m_eventsSent;
+}
+
+uint64_t UInputDevice::getPacketsSent()
+{
+	return m_packetsSent;
+}
+
+// Helper methods
+
+// Needs letter keys and LEDs, otherwise device won't be recognized as a keyboard
+bool UInputDevice::setupKeyboard()
+{
+	bool result = enableBit(UI_SET_EVBIT, EV_KEY) && enableBit(UI_SET_EVBIT, EV_LED);
+
+	for (int key = KEY_ESC; result && key <= KEY_KPDOT; key++)
+	{
+		result = enableBit(UI_SET_KEYBIT, key);
+	}
+
+	result = result &&
+		enableBit(UI_SET_LEDBIT, LED_NUML) &&
+		enableBit(UI_SET_LEDBIT, LED_CAPSL) &&
+		enableBit(UI_SET_LEDBIT, LED_SCROLLL);
+
+	return result;
+}
+
+bool UInputDevice::setupMouse()
+{
+	bool result =
+		enableBit(UI_SET_EVBIT, EV_KEY) &&
+		enableBit(UI_SET_EVBIT, EV_REL) &&
+		enableBit(UI_SET_KEYBIT, BTN_LEFT) &&
+		enableBit(UI_SET_KEYBIT, BTN_RIGHT) &&
+		enableBit(UI_SET_KEYBIT, BTN_MIDDLE) &&
+		enableBit(UI_SET_RELBIT, REL_X) &&
+		enableBit(UI_SET_RELBIT, REL_Y) &&
+		enableBit(UI_SET_RELBIT, REL_WHEEL);
+
+	return result;
+}
+
+bool UInputDevice::setupJoystick()
+{
+	bool result = enableBit(UI_SET_EVBIT, EV_KEY) && enableBit(UI_SET_EVBIT, EV_ABS);
+
+	for (int button = BTN_SOUTH; result && button <= BTN_THUMBR; button++)
+	{
+		result = enableBit(UI_SET_KEYBIT, button);
+	}
+
+	for (int axis : { ABS_X, ABS_Y, ABS_RX, ABS_RY, ABS_HAT0X, ABS_HAT0Y })
+	{
+		result = result && enableBit(UI_SET_ABSBIT, axis);
+	}
+
+	return result;
+}
+
+bool UInputDevice::enableBit(unsigned long request, int bit)
+{
+	bool result = ioctl(m_fd, request, bit) >= 0;
+
+	return result;
+}
+
+// Resolve event<N> name using sysfs: /sys/devices/virtual/input/input<M>/event<N>
+string UInputDevice::queryEventName()
+{
+	string result;
+
+	char sysName[64] = { 0 };
+	if (ioctl(m_fd, UI_GET_SYSNAME(sizeof(sysName)), sysName) < 0)
+	{
+		LOGWARN("%s: UI_GET_SYSNAME is not supported by kernel", __PRETTY_FUNCTION__);
+		return result;
+	}
+
+	string path = Path::combine(LINUX_VIRTUAL_INPUT_DEVICES, sysName).toString();
+
+	ScanDir scan;
+	scan.scanFolder(path, ScanDir::getInputDevicesFilter());
+
+	auto entries = scan.getScanResults();
+	if (entries.size() > 0)
+	{
+		result = entries[0].name;
+	}
+
+	scan.dispose();
+
+	return result;
+}
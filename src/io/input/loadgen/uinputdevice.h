@@ -0,0 +1,56 @@
+#ifndef IO_INPUT_LOADGEN_UINPUTDEVICE_H_
+#define IO_INPUT_LOADGEN_UINPUTDEVICE_H_
+
+#include <stdint.h>
+#include <string>
+#include "../../../common/consts.h"
+#include "../../../common/types.h"
+
+using namespace std;
+
+#define LINUX_UINPUT_DEVICE "/dev/uinput"
+#define LINUX_VIRTUAL_INPUT_DEVICES "/sys/devices/virtual/input"
+
+// Virtual input device created via /dev/uinput
+// Appears in /dev/input as a regular evdev device, so it's detected and polled by the real input stack
+class UInputDevice
+{
+protected:
+	int m_fd = INVALID_FILE_DESCRIPTOR;
+	InputDeviceTypeEnum m_type = InputDeviceTypeEnum::Unknown;
+	string m_model;
+	string m_eventName;
+
+	uint64_t m_eventsSent = 0;
+	uint64_t m_packetsSent = 0;
+
+public:
+	UInputDevice() {};
+	virtual ~UInputDevice();
+
+	UInputDevice(const UInputDevice& that) = delete; 			// Disable copy constructor (C++11 feature)
+	UInputDevice& operator =(UInputDevice const&) = delete;		// Disable assignment operator (C++11 feature)
+
+	bool create(InputDeviceTypeEnum type, const string& model);
+	void destroy();
+
+	bool emit(uint16_t type, uint16_t code, int32_t value);
+	bool sync();
+
+	InputDeviceTypeEnum getType();
+	const string& getModel();
+	const string& getEventName();
+	uint64_t getEventsSent();
+	uint64_t getPacketsSent();
+
+// Helper methods
+protected:
+	bool setupKeyboard();
+	bool setupMouse();
+	bool setupJoystick();
+	bool enableBit(unsigned long request, int bit);
+
+	string queryEventName();
+};
+
+#endif /* IO_INPUT_LOADGEN_UINPUTDEVICE_H_ */
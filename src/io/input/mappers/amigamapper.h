@@ -2,16 +2,22 @@
 #define IO_INPUT_MAPPERS_AMIGAMAPPER_H_
 
 #include <stdint.h>
+#include "keymaptable.h"
 
-#include "basemapper.h"
-
-class AmigaMapper: public BaseMapper
+// Translates evdev key codes into Amiga raw key codes (Minimig)
+// Tables are generated at compile time, lookup is a single bounds-checked load (no virtual calls)
+class AmigaMapper final
 {
-protected:
-	static const uint32_t map[];
-
 public:
-	uint32_t getCode(uint16_t key);
+	static const KeyMapTable& getTable(KeyboardLayout layout = KeyboardLayout::ANSI);
+
+	static inline uint32_t getCode(uint16_t key, KeyboardLayout layout = KeyboardLayout::ANSI)
+	{
+		return getTable(layout).getCode(key);
+	}
+
+private:
+	AmigaMapper() {}; // Static class, disallow objects creation
 };
 
 #endif /* IO_INPUT_MAPPERS_AMIGAMAPPER_H_ */
@@ -0,0 +1,17 @@
+#include "keymapper.h"
+
+#include "amigamapper.h"
+#include "ps2mapper.h"
+
+const KeyMapTable& KeyMapper::getTable(CoreType type, KeyboardLayout layout)
+{
+	switch (type)
+	{
+		// Minimig expects Amiga raw key codes
+		case CoreType::CORE_TYPE_MINIMIG2:
+			return AmigaMapper::getTable(layout);
+		// The rest of cores use PS/2 scan codes
+		default:
+			return PS2Mapper::getTable(layout);
+	}
+}
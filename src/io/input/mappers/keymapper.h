@@ -0,0 +1,19 @@
+#ifndef IO_INPUT_MAPPERS_KEYMAPPER_H_
+#define IO_INPUT_MAPPERS_KEYMAPPER_H_
+
+#include <stdint.h>
+#include "keymaptable.h"
+#include "../../../fpga/fpgacommand.h"
+
+// Selects translation table for the core type. Should be resolved once (on core start)
+// and the table reference used directly for each key event afterwards
+class KeyMapper
+{
+public:
+	static const KeyMapTable& getTable(CoreType type, KeyboardLayout layout = KeyboardLayout::ANSI);
+
+private:
+	KeyMapper() {}; // Static class, disallow objects creation
+};
+
+#endif /* IO_INPUT_MAPPERS_KEYMAPPER_H_ */
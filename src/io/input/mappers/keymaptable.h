@@ -0,0 +1,80 @@
+#ifndef IO_INPUT_MAPPERS_KEYMAPTABLE_H_
+#define IO_INPUT_MAPPERS_KEYMAPTABLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <linux/input.h>
+#include "../input.h"
+
+// Number of evdev key codes covered by translation tables (codes above are always translated to NONE)
+#define KEYMAP_SIZE 256
+
+// Regional keyboard variants. Applied as overlays on top of the base (ANSI / US) table
+enum class KeyboardLayout: uint8_t
+{
+	ANSI = 0,	// US 104-key
+	ISO,		// European 105-key (extra key between Left Shift and Z)
+	JIS			// Japanese 109-key
+};
+
+// Single translation rule: evdev key code => core key code (with modifier / flag bits)
+struct KeyMapEntry
+{
+	uint16_t key;
+	uint32_t code;
+};
+typedef struct KeyMapEntry KeyMapEntry;
+
+// Dense translation table, indexed by evdev key code
+// Instances are expected to be produced by KeyMapBuilder in constexpr context, so they're placed into .rodata
+// and no initialization / parsing happens in runtime
+struct KeyMapTable
+{
+	uint32_t codes[KEYMAP_SIZE];
+
+	constexpr uint32_t getCode(uint16_t key) const
+	{
+		return key < KEYMAP_SIZE ? codes[key] : NONE;
+	}
+};
+typedef struct KeyMapTable KeyMapTable;
+
+// Compile-time (C++14 constexpr) table builders
+class KeyMapBuilder
+{
+public:
+	// Creates table with all keys translated to NONE except listed in <entries>
+	template <size_t N>
+	static constexpr KeyMapTable build(const KeyMapEntry (&entries)[N])
+	{
+		KeyMapTable result {};
+
+		for (size_t i = 0; i < KEYMAP_SIZE; i++)
+		{
+			result.codes[i] = NONE;
+		}
+
+		return overlay(result, entries);
+	}
+
+	// Creates copy of <base> table with translations from <entries> replacing original ones
+	// Entries with key code outside of table range break constexpr evaluation (so detected at compile time)
+	template <size_t N>
+	static constexpr KeyMapTable overlay(const KeyMapTable& base, const KeyMapEntry (&entries)[N])
+	{
+		KeyMapTable result = base;
+
+		for (size_t i = 0; i < N; i++)
+		{
+			const KeyMapEntry& entry = entries[i];
+			result.codes[entry.key < KEYMAP_SIZE ? entry.key : throw "Key code is out of translation table range"] = entry.code;
+		}
+
+		return result;
+	}
+
+private:
+	KeyMapBuilder() {}; // Static class, disallow objects creation
+};
+
+#endif /* IO_INPUT_MAPPERS_KEYMAPTABLE_H_ */
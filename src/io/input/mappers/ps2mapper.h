@@ -2,15 +2,22 @@
 #define IO_INPUT_MAPPERS_PS2MAPPER_H_
 
 #include <stdint.h>
-#include "basemapper.h"
+#include "keymaptable.h"
 
-class PS2Mapper: public BaseMapper
+// Translates evdev key codes into PS/2 (set 2) scan codes. Used by most cores
+// Tables are generated at compile time, lookup is a single bounds-checked load (no virtual calls)
+class PS2Mapper final
 {
-protected:
-	static const uint32_t map[];
-
 public:
-	uint32_t getCode(uint16_t key);
+	static const KeyMapTable& getTable(KeyboardLayout layout = KeyboardLayout::ANSI);
+
+	static inline uint32_t getCode(uint16_t key, KeyboardLayout layout = KeyboardLayout::ANSI)
+	{
+		return getTable(layout).getCode(key);
+	}
+
+private:
+	PS2Mapper() {}; // Static class, disallow objects creation
 };
 
 #endif /* IO_INPUT_MAPPERS_PS2MAPPER_H_ */
@@ -1,10 +1,428 @@
 #include "mouseemulator.h"
 
-MouseEmulator::MouseEmulator()
+#include "../../common/logger/logger.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+#include <linux/input.h>
+#include "../../fpga/fpgadevice.h"
+#include "joystickreporter.h"
+
+// Out-of-class definitions for constants (required for C++14 if constant is odr-used)
+constexpr int32_t MouseEmulator::DIGITAL_MIN_SPEED;
+constexpr int32_t MouseEmulator::DIGITAL_MAX_SPEED;
+constexpr int32_t MouseEmulator::DIGITAL_ACCELERATION;
+constexpr int32_t MouseEmulator::ANALOG_MAX_SPEED;
+
+MouseEmulator& MouseEmulator::instance()
+{
+	static MouseEmulator instance;
+
+	return instance;
+}
+
+MouseEmulator::MouseEmulator() : Runnable("mouse_emu"), m_useJoystick(false)
 {
+	m_mode = EMU_NONE;
 }
 
 MouseEmulator::~MouseEmulator()
 {
+	dispose();
+}
+
+bool MouseEmulator::init()
+{
+	bool result = false;
+
+	if (m_fd_timer != INVALID_FILE_DESCRIPTOR)
+		return true;
+
+	m_fd_timer = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+	if (m_fd_timer != INVALID_FILE_DESCRIPTOR)
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexTimer);
+
+		if (setTimer(m_mode != EMU_NONE))
+		{
+			result = true;
+		}
+		else
+		{
+			close(m_fd_timer);
+			m_fd_timer = INVALID_FILE_DESCRIPTOR;
+		}
+	}
+	else
+	{
+		LOGERROR("%s: unable to create tick timer: %s", __PRETTY_FUNCTION__, logger::geterror());
+	}
+
+	return result;
 }
 
+void MouseEmulator::dispose()
+{
+	if (!m_stopped)
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexTimer);
+
+		// Thread waits for the tick even if emulation is off - wake it up, so it can notice stop request
+
+		m_stop = true;
+		setTimer(true);
+	}
+
+	stop();
+
+	if (m_fd_timer != INVALID_FILE_DESCRIPTOR)
+	{
+		close(m_fd_timer);
+		m_fd_timer = INVALID_FILE_DESCRIPTOR;
+	}
+}
+
+emu_mode_t MouseEmulator::getMode()
+{
+	return m_mode;
+}
+
+// Timer stays armed after switching to EMU_NONE till the next tick releases emulated state
+void MouseEmulator::setMode(emu_mode_t mode)
+{
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexTimer);
+
+	m_mode = mode;
+
+	if (mode != EMU_NONE)
+	{
+		setTimer(true);
+	}
+
+	updateJoystickMute();
+}
+
+// Cycle through modes: none -> mouse -> joystick 0 -> joystick 1 -> none (NumLock)
+emu_mode_t MouseEmulator::switchMode()
+{
+	emu_mode_t mode = m_mode;
+	emu_mode_t result = mode == EMU_JOY1 ? EMU_NONE : (emu_mode_t)(mode + 1);
+
+	setMode(result);
+
+	return result;
+}
+
+void MouseEmulator::setDigitalState(uint32_t state)
+{
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexInput);
+
+	m_input.digital = state;
+}
+
+bool MouseEmulator::isJoystickSource()
+{
+	return m_useJoystick;
+}
+
+// Joystick on the first port drives the cursor in mouse mode (stick - with quadratic response, d-pad - as keypad).
+// Core doesn't get that port state while it's merged into the mouse
+void MouseEmulator::setJoystickSource(bool isEnabled)
+{
+	// Lock parallel threads to access (active till return from method and lock destruction)
+	lock_guard<mutex> lock(m_mutexTimer);
+
+	m_useJoystick = isEnabled;
+
+	updateJoystickMute();
+}
+
+// Keypad emulation layout: 8/2/4/6 - directions, 7/9/1/3 - diagonals, 0 / Del / 5 - buttons
+static const struct { uint16_t key; uint32_t mask; } keypadLayout[] =
+{
+	{ KEY_KP8, JOY_UP },
+	{ KEY_KP2, JOY_DOWN },
+	{ KEY_KP4, JOY_LEFT },
+	{ KEY_KP6, JOY_RIGHT },
+	{ KEY_KP7, JOY_UP | JOY_LEFT },
+	{ KEY_KP9, JOY_UP | JOY_RIGHT },
+	{ KEY_KP1, JOY_DOWN | JOY_LEFT },
+	{ KEY_KP3, JOY_DOWN | JOY_RIGHT },
+	{ KEY_KP0, JOY_BTN1 },
+	{ KEY_KPDOT, JOY_BTN2 },
+	{ KEY_KP5, JOY_BTN3 }
+};
+
+uint32_t MouseEmulator::getKeypadState(const KeyBitset& keys)
+{
+	uint32_t result = 0;
+
+	for (auto& item : keypadLayout)
+	{
+		result |= keys.test(item.key) ? item.mask : 0;
+	}
+
+	return result;
+}
+
+// Keys used for emulation (they're not passed to the core while emulation is active)
+void MouseEmulator::getKeypadKeys(KeyBitset& keys)
+{
+	for (auto& item : keypadLayout)
+	{
+		keys.set(item.key, true);
+	}
+}
+
+// Helper methods
+
+// Start / stop periodic ticks. Should be called with m_mutexTimer locked
+bool MouseEmulator::setTimer(bool isArmed)
+{
+	bool result = false;
+
+	if (m_fd_timer == INVALID_FILE_DESCRIPTOR)
+		return result;
+
+	// Zero value disarms the timer
+	itimerspec interval;
+	interval.it_interval.tv_sec = 0;
+	interval.it_interval.tv_nsec = isArmed ? MOUSE_EMU_TICK_INTERVAL * 1000000L : 0;
+	interval.it_value = interval.it_interval;
+
+	if (timerfd_settime(m_fd_timer, 0, &interval, nullptr) == 0)
+	{
+		result = true;
+	}
+	else
+	{
+		LOGERROR("%s: unable to %s tick timer: %s", __PRETTY_FUNCTION__, isArmed ? "arm" : "disarm", logger::geterror());
+	}
+
+	return result;
+}
+
+// Port 0 is muted only while it's really merged into the mouse. Should be called with m_mutexTimer locked
+void MouseEmulator::updateJoystickMute()
+{
+	JoystickReporter::instance().setMuted(0, m_useJoystick && m_mode == EMU_MOUSE);
+}
+
+void MouseEmulator::tick(unsigned ticks)
+{
+	emu_mode_t mode = m_mode;
+
+	EmulatorInput input;
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexInput);
+
+		input = m_input;
+	}
+
+	switch (mode)
+	{
+		case EMU_MOUSE:
+			{
+				// Joystick on the first port can drive the cursor as well
+				if (m_useJoystick)
+				{
+					JoystickState joystick = JoystickReporter::instance().getInputState(0);
+					input.digital |= joystick.buttons;
+
+					input.analogX = joystick.axes[0];
+					input.analogY = joystick.axes[1];
+				}
+
+				tickMouse(input, ticks);
+			}
+			break;
+		case EMU_JOY0:
+			tickJoystick(input, 0);
+			break;
+		case EMU_JOY1:
+			tickJoystick(input, 1);
+			break;
+		default:
+			m_digitalSpeed = 0;
+			m_accumulatorX = 0;
+			m_accumulatorY = 0;
+			break;
+	}
+
+	// Joystick emulation switched off - release everything it held
+	if (mode != EMU_JOY0 && mode != EMU_JOY1 && m_joystickPort >= 0)
+	{
+		sendJoystick(-1, 0);
+	}
+
+	// Emulation is off and released - no more ticks till mode is switched on (mode is checked again, it could be just changed)
+	if (mode == EMU_NONE)
+	{
+		// Lock parallel threads to access (active till the end of the block)
+		lock_guard<mutex> lock(m_mutexTimer);
+
+		if (m_mode == EMU_NONE && !m_stop)
+		{
+			setTimer(false);
+		}
+	}
+}
+
+void MouseEmulator::tickMouse(const EmulatorInput& input, unsigned ticks)
+{
+	uint32_t digital = input.digital;
+
+	// Digital directions accelerate linearly from min to max speed while held
+	if (digital & JOY_MOVE)
+	{
+		int32_t speed = m_digitalSpeed == 0 ? DIGITAL_MIN_SPEED : m_digitalSpeed + DIGITAL_ACCELERATION * (int32_t)ticks;
+		m_digitalSpeed = speed > DIGITAL_MAX_SPEED ? DIGITAL_MAX_SPEED : speed;
+	}
+	else
+	{
+		m_digitalSpeed = 0;
+	}
+
+	int32_t directionX = ((digital & JOY_RIGHT) ? 1 : 0) - ((digital & JOY_LEFT) ? 1 : 0);
+	int32_t directionY = ((digital & JOY_DOWN) ? 1 : 0) - ((digital & JOY_UP) ? 1 : 0);
+
+	int32_t velocityX = directionX * m_digitalSpeed + getAnalogSpeed(input.analogX);
+	int32_t velocityY = directionY * m_digitalSpeed + getAnalogSpeed(input.analogY);
+
+	// Drop sub-pixel remainders once motion stops, so the cursor doesn't creep on next move
+	m_accumulatorX = velocityX != 0 ? m_accumulatorX + velocityX * (int32_t)ticks : 0;
+	m_accumulatorY = velocityY != 0 ? m_accumulatorY + velocityY * (int32_t)ticks : 0;
+
+	int32_t dx = takeWholePixels(m_accumulatorX);
+	int32_t dy = takeWholePixels(m_accumulatorY);
+
+	uint8_t buttons =
+		((digital & JOY_BTN1) ? 0x01 : 0) |
+		((digital & JOY_BTN2) ? 0x02 : 0) |
+		((digital & JOY_BTN3) ? 0x04 : 0);
+
+	// Single coalesced report per tick, nothing is sent if there are no changes
+	if (dx != 0 || dy != 0 || buttons != m_sentButtons)
+	{
+		sendMouse(buttons, (int8_t)dx, (int8_t)dy);
+	}
+}
+
+void MouseEmulator::tickJoystick(const EmulatorInput& input, uint8_t port)
+{
+	if (input.digital != m_sentJoystick || port != m_joystickPort)
+	{
+		sendJoystick(port, input.digital);
+	}
+}
+
+// Quadratic response: fine control near the center, full speed on max deflection
+int32_t MouseEmulator::getAnalogSpeed(int8_t value)
+{
+	int32_t result = (int32_t)value * (value < 0 ? -value : value) * ANALOG_MAX_SPEED / (127 * 127);
+
+	return result;
+}
+
+// Extract whole pixels (single report can carry up to 127 pixels) leaving fractional part in accumulator
+int32_t MouseEmulator::takeWholePixels(int32_t& accumulator)
+{
+	int32_t result = accumulator / 256;
+
+	result = result > 127 ? 127 : result;
+	result = result < -127 ? -127 : result;
+	accumulator -= result * 256;
+
+	return result;
+}
+
+// Sends PS/2-style mouse packet: [flags + buttons] [dx] [dy]
+void MouseEmulator::sendMouse(uint8_t buttons, int8_t dx, int8_t dy)
+{
+	FPGACommand* command = FPGADevice::instance().command;
+
+	// PS/2 uses positive Y for upward movement
+	int8_t ps2dy = -dy;
+
+	uint8_t data[] =
+	{
+		(uint8_t)((buttons & 0x07) | 0x08 | (dx < 0 ? 0x10 : 0) | (ps2dy < 0 ? 0x20 : 0)),
+		(uint8_t)dx,
+		(uint8_t)ps2dy
+	};
+
+	if (command != nullptr && command->startIO())
+	{
+		command->sendCommand(UIO_MOUSE, data, sizeof(data));
+		command->endIO();
+
+		m_sentButtons = buttons;
+	}
+	else
+	{
+		// FPGA is busy - keep motion for the next tick
+		m_accumulatorX += dx * 256;
+		m_accumulatorY += dy * 256;
+	}
+}
+
+// Keypad state is merged by JoystickReporter with physical joysticks assigned to the same port
+// and transferred together with them. <port> -1 only releases previously emulated port
+void MouseEmulator::sendJoystick(int port, uint32_t state)
+{
+	JoystickReporter& reporter = JoystickReporter::instance();
+
+	if (m_joystickPort >= 0 && m_joystickPort != port)
+	{
+		reporter.setVirtualButtons(m_joystickPort, 0);
+	}
+
+	if (port >= 0)
+	{
+		reporter.setVirtualButtons(port, state);
+	}
+
+	m_joystickPort = port;
+	m_sentJoystick = state;
+}
+
+// Runnable override method(s)
+
+// Async thread body
+void MouseEmulator::run()
+{
+	LOGINFO("MouseEmulator: thread started with tid: %d (0x%x)", m_thread_id, m_thread_id);
+
+	if (m_fd_timer == INVALID_FILE_DESCRIPTOR)
+	{
+		LOGERROR("%s: tick timer is not initialized. Call init() first", __PRETTY_FUNCTION__);
+		return;
+	}
+
+	while (!m_stop)
+	{
+		// Blocks till the next tick. Number of expirations > 1 means some ticks were missed
+		uint64_t expirations = 0;
+		ssize_t len = read(m_fd_timer, &expirations, sizeof(expirations));
+
+		if (len == sizeof(expirations))
+		{
+			// Missed ticks are compensated (up to 10), so cursor speed stays constant
+			tick(expirations > 10 ? 10 : (unsigned)expirations);
+		}
+		else if (len < 0 && errno != EINTR)
+		{
+			LOGERROR("%s: %s", __PRETTY_FUNCTION__, logger::geterror());
+			break;
+		}
+	}
+
+	LOGINFO("MouseEmulator: thread with tid: %d (0x%x) loop stopped", m_thread_id, m_thread_id);
+}
@@ -1,16 +1,100 @@
 #ifndef IO_INPUT_MOUSEEMULATOR_H_
 #define IO_INPUT_MOUSEEMULATOR_H_
 
-class MouseEmulator
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include "../../common/consts.h"
+#include "../../common/thread/runnable.h"
+#include "../../fpga/fpgacommand.h"
+#include "keybitset.h"
+
+using namespace std;
+
+// Emulation source state (JOY_* direction / button bits + analog stick from the first joystick port)
+struct EmulatorInput
+{
+	uint32_t digital = 0;
+	int8_t analogX = 0;
+	int8_t analogY = 0;
+};
+typedef struct EmulatorInput EmulatorInput;
+
+// Emulates mouse (EMU_MOUSE) or joystick (EMU_JOY0 / EMU_JOY1) using keypad / joystick state
+// Runs at fixed tick (timerfd driven), so cursor speed doesn't depend on source event rate
+// and exactly one coalesced report per tick (at most) is sent to the core.
+// Tick timer is disarmed while emulation is off (EMU_NONE), so the thread sleeps instead of waking up each tick
+class MouseEmulator : public Runnable
 {
 protected:
-	// Fields
-	int prev_dx = 0;
-	int prev_dy = 0;
+	// Acceleration parameters (speed values are in Q8 pixels per tick)
+	static constexpr int32_t DIGITAL_MIN_SPEED = 1 << 8;			// 1px per tick when direction key pressed
+	static constexpr int32_t DIGITAL_MAX_SPEED = 8 << 8;			// 8px per tick after acceleration
+	static constexpr int32_t DIGITAL_ACCELERATION = 16;			// Speed increment per tick while direction is held
+	static constexpr int32_t ANALOG_MAX_SPEED = 12 << 8;			// Full stick deflection
+
+	atomic<emu_mode_t> m_mode;
+
+	mutex m_mutexInput;
+	EmulatorInput m_input;
+	atomic<bool> m_useJoystick;		// Mouse mode takes the first joystick port in addition to keypad (port is muted for the core meanwhile)
+
+	mutex m_mutexTimer;
+	int m_fd_timer = INVALID_FILE_DESCRIPTOR;
+
+	// Motion state (accessed from emulator thread only)
+	int32_t m_digitalSpeed = 0;
+	int32_t m_accumulatorX = 0;		// Sub-pixel remainders (Q8)
+	int32_t m_accumulatorY = 0;
+	uint8_t m_sentButtons = 0;
+	uint32_t m_sentJoystick = 0;
+	int m_joystickPort = -1;		// Port keypad joystick state was reported to (-1 - none)
 
 public:
-	MouseEmulator();
+	// Singleton instance
+	static MouseEmulator& instance();
+	MouseEmulator(MouseEmulator&&) = delete;						// Disable move constructor (C++11 feature)
+	MouseEmulator(const MouseEmulator& that) = delete; 			// Disable copy constructor (C++11 feature)
+	MouseEmulator& operator =(MouseEmulator const&) = delete;		// Disable assignment operator (C++11 feature)
 	virtual ~MouseEmulator();
+
+public:
+	bool init();
+	void dispose();
+
+	emu_mode_t getMode();
+	void setMode(emu_mode_t mode);
+	emu_mode_t switchMode();
+
+	void setDigitalState(uint32_t state);
+
+	bool isJoystickSource();
+	void setJoystickSource(bool isEnabled);
+
+	static uint32_t getKeypadState(const KeyBitset& keys);
+	static void getKeypadKeys(KeyBitset& keys);
+
+// Helper methods
+protected:
+	bool setTimer(bool isArmed);
+	void updateJoystickMute();
+	void tick(unsigned ticks);
+	void tickMouse(const EmulatorInput& input, unsigned ticks);
+	void tickJoystick(const EmulatorInput& input, uint8_t port);
+
+	int32_t getAnalogSpeed(int8_t value);
+	static int32_t takeWholePixels(int32_t& accumulator);
+
+	void sendMouse(uint8_t buttons, int8_t dx, int8_t dy);
+	void sendJoystick(int port, uint32_t state);
+
+// Runnable override method(s)
+protected:
+	// Async thread body
+	void run();
+
+private:
+	MouseEmulator();	// Disable explicit object creation (only singleton instance allowed)
 };
 
 #endif /* IO_INPUT_MOUSEEMULATOR_H_ */
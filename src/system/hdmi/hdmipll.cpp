@@ -369,7 +369,8 @@ void HDMIPLL::setVideoMode(HDMIVideoModePacket* modePacket)
 	FPGAConnector& connector = *(fpga.connector);
 	FPGACommand& command = *(fpga.command);
 
-	if (command.startIO())
+	// Core set-up command - waits for any transfer in progress instead of being dropped
+	if (command.startIO(true))
 	{
 		command.sendCommand(UIO_SET_VIDEO);
 